@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+
+// Define as 1 (for example with -DTRACK_ALLOCATIONS=1) to replace the global operator new and delete
+// with versions that count every heap allocation by the phase of the thread making it
+#ifndef TRACK_ALLOCATIONS
+#define TRACK_ALLOCATIONS 0
+#endif
+
+namespace Pentominoes
+{
+	enum class AllocationPhase
+	{
+		Other,            // Setup, threads, collecting and printing results
+		Search,           // Placing and removing pieces and pruning branches. Should never allocate.
+		SolutionStorage,  // A solver storing a solution in its arena, once per block
+		SolutionHandling, // Solution callbacks, such as canonicalizing solutions to remove trivial ones
+		Total
+	};
+
+	// Allocation counts for all threads since the last reset(). Always 0 unless TRACK_ALLOCATIONS is 1.
+	class AllocationTracker
+	{
+	public:
+		static constexpr bool cEnabled{ TRACK_ALLOCATIONS != 0 };
+
+		static int64_t getCount(AllocationPhase phase);
+		static void reset();
+		static void print();
+		static const char* getPhaseName(AllocationPhase phase);
+	};
+
+	// Counts this thread's allocations in the given phase until it goes out of scope
+	class AllocationScope
+	{
+	public:
+#if TRACK_ALLOCATIONS
+		explicit AllocationScope(AllocationPhase phase);
+		~AllocationScope();
+#else
+		explicit AllocationScope(AllocationPhase) {}
+#endif
+		AllocationScope(const AllocationScope&) = delete;
+		AllocationScope& operator=(const AllocationScope&) = delete;
+
+	private:
+#if TRACK_ALLOCATIONS
+		AllocationPhase mPrevious{};
+#endif
+	};
+}
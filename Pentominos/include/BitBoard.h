@@ -0,0 +1,257 @@
+#pragma once
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Pentominoes
+{
+	inline int popCount64(uint64_t value)
+	{
+#if defined(_MSC_VER)
+		return static_cast<int>(__popcnt64(value));
+#else
+		return __builtin_popcountll(value);
+#endif
+	}
+
+	// Precondition: value != 0
+	inline int countTrailingZeros64(uint64_t value)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+
+	inline uint64_t reverseBits64(uint64_t value)
+	{
+		value = ((value >> 1) & 0x5555555555555555ull) | ((value & 0x5555555555555555ull) << 1);
+		value = ((value >> 2) & 0x3333333333333333ull) | ((value & 0x3333333333333333ull) << 2);
+		value = ((value >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((value & 0x0F0F0F0F0F0F0F0Full) << 4);
+		value = ((value >> 8) & 0x00FF00FF00FF00FFull) | ((value & 0x00FF00FF00FF00FFull) << 8);
+		value = ((value >> 16) & 0x0000FFFF0000FFFFull) | ((value & 0x0000FFFF0000FFFFull) << 16);
+		return (value >> 32) | (value << 32);
+	}
+
+	// Transpose an 8x8 bit matrix stored one row per byte, bit c of byte r is cell (r, c).
+	// Swaps 2x2, then 4x4 blocks of bits inside 8x8 blocks, then the 4x4 quadrants.
+	inline uint64_t transpose8x8(uint64_t value)
+	{
+		uint64_t swap{ (value ^ (value >> 7)) & 0x00AA00AA00AA00AAull };
+		value ^= swap ^ (swap << 7);
+		swap = (value ^ (value >> 14)) & 0x0000CCCC0000CCCCull;
+		value ^= swap ^ (swap << 14);
+		swap = (value ^ (value >> 28)) & 0x00000000F0F0F0F0ull;
+		value ^= swap ^ (swap << 28);
+		return value;
+	}
+
+	// Fixed size set of board cells, one bit per cell, spread over Words 64 bit words.
+	// Bit i lives in word i / 64, so shifts carry across word boundaries like a single wide integer.
+	template <int Words>
+	struct BitBoard
+	{
+		static constexpr int cBits{ 64 * Words };
+
+		uint64_t words[Words]{};
+
+		void set(int i) { words[i >> 6] |= uint64_t{ 1 } << (i & 63); }
+		void clear(int i) { words[i >> 6] &= ~(uint64_t{ 1 } << (i & 63)); }
+		bool test(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+		bool isEmpty() const
+		{
+			uint64_t any{ 0 };
+			for (int w = 0; w < Words; w++)
+				any |= words[w];
+			return any == 0;
+		}
+
+		int popCount() const
+		{
+			int count{ 0 };
+			for (int w = 0; w < Words; w++)
+				count += popCount64(words[w]);
+			return count;
+		}
+
+		// Index of the lowest set bit, or -1 if empty
+		int findFirst() const
+		{
+			for (int w = 0; w < Words; w++)
+			{
+				if (words[w])
+					return w * 64 + countTrailingZeros64(words[w]);
+			}
+			return -1;
+		}
+
+		// Board containing only the lowest set bit
+		// Precondition: !isEmpty()
+		BitBoard lowestBit() const
+		{
+			BitBoard result{};
+			for (int w = 0; w < Words; w++)
+			{
+				if (words[w])
+				{
+					result.words[w] = words[w] & (~words[w] + 1);
+					break;
+				}
+			}
+			return result;
+		}
+
+		// Returns true if every cell of this board is also set in other
+		bool isSubsetOf(const BitBoard& other) const
+		{
+			uint64_t outside{ 0 };
+			for (int w = 0; w < Words; w++)
+				outside |= words[w] & ~other.words[w];
+			return outside == 0;
+		}
+
+		bool intersects(const BitBoard& other) const
+		{
+			uint64_t common{ 0 };
+			for (int w = 0; w < Words; w++)
+				common |= words[w] & other.words[w];
+			return common != 0;
+		}
+
+		// Bits [start, start + length) as an integer, reading bits outside the board as 0.
+		// start may be negative. Precondition: 0 < length < 64
+		uint64_t extractBits(int start, int length) const
+		{
+			int word{ start >> 6 };
+			int bit{ start & 63 };
+			uint64_t value{ word >= 0 && word < Words ? words[word] >> bit : 0 };
+			if (bit && word + 1 >= 0 && word + 1 < Words)
+				value |= words[word + 1] << (64 - bit);
+			return value & ((uint64_t{ 1 } << length) - 1);
+		}
+
+		// OR the low length bits of value into bits [start, start + length)
+		// Precondition: 0 <= start, start + length <= cBits, 0 < length < 64
+		void depositBits(int start, int length, uint64_t value)
+		{
+			value &= (uint64_t{ 1 } << length) - 1;
+			int word{ start >> 6 };
+			int bit{ start & 63 };
+			words[word] |= value << bit;
+			// Always true by the precondition, but lets the compiler see the last word is never passed
+			if (bit + length > 64 && word + 1 < Words)
+				words[word + 1] |= value >> (64 - bit);
+		}
+
+		// Precondition: 0 <= n < cBits
+		BitBoard shiftedLeft(int n) const
+		{
+			BitBoard result{};
+			int wordShift{ n >> 6 };
+			int bitShift{ n & 63 };
+			for (int w = Words - 1; w >= wordShift; w--)
+			{
+				uint64_t value{ words[w - wordShift] << bitShift };
+				if (bitShift && w - wordShift - 1 >= 0)
+					value |= words[w - wordShift - 1] >> (64 - bitShift);
+				result.words[w] = value;
+			}
+			return result;
+		}
+
+		// Precondition: 0 <= n < cBits
+		BitBoard shiftedRight(int n) const
+		{
+			BitBoard result{};
+			int wordShift{ n >> 6 };
+			int bitShift{ n & 63 };
+			for (int w = 0; w + wordShift < Words; w++)
+			{
+				uint64_t value{ words[w + wordShift] >> bitShift };
+				if (bitShift && w + wordShift + 1 < Words)
+					value |= words[w + wordShift + 1] << (64 - bitShift);
+				result.words[w] = value;
+			}
+			return result;
+		}
+
+		// Grow the seed through 4-connected cells of open until it stops changing.
+		// Cells are laid out row by row with the given stride, and the last column of each
+		// row must be a guard column that is never open, so horizontal shifts can't wrap.
+		static BitBoard floodFill(const BitBoard& seed, const BitBoard& open, int stride)
+		{
+			BitBoard fill{ seed & open };
+			while (true)
+			{
+				BitBoard grown{ (fill | fill.shiftedLeft(1) | fill.shiftedRight(1)
+					| fill.shiftedLeft(stride) | fill.shiftedRight(stride)) & open };
+				if (grown == fill)
+					return fill;
+				fill = grown;
+			}
+		}
+
+		// Same as floodFill(), with the stride known at compile time so every shift is by a constant
+		template <int Stride>
+		static BitBoard floodFill(const BitBoard& seed, const BitBoard& open)
+		{
+			BitBoard fill{ seed & open };
+			while (true)
+			{
+				BitBoard grown{ (fill | fill.shiftedLeft(1) | fill.shiftedRight(1)
+					| fill.shiftedLeft(Stride) | fill.shiftedRight(Stride)) & open };
+				if (grown == fill)
+					return fill;
+				fill = grown;
+			}
+		}
+
+		BitBoard& operator&=(const BitBoard& other)
+		{
+			for (int w = 0; w < Words; w++)
+				words[w] &= other.words[w];
+			return *this;
+		}
+
+		BitBoard& operator|=(const BitBoard& other)
+		{
+			for (int w = 0; w < Words; w++)
+				words[w] |= other.words[w];
+			return *this;
+		}
+
+		BitBoard& operator^=(const BitBoard& other)
+		{
+			for (int w = 0; w < Words; w++)
+				words[w] ^= other.words[w];
+			return *this;
+		}
+
+		// Remove every cell of other from this board
+		BitBoard& operator-=(const BitBoard& other)
+		{
+			for (int w = 0; w < Words; w++)
+				words[w] &= ~other.words[w];
+			return *this;
+		}
+
+		friend BitBoard operator&(BitBoard a, const BitBoard& b) { return a &= b; }
+		friend BitBoard operator|(BitBoard a, const BitBoard& b) { return a |= b; }
+		friend BitBoard operator^(BitBoard a, const BitBoard& b) { return a ^= b; }
+		friend BitBoard operator-(BitBoard a, const BitBoard& b) { return a -= b; }
+
+		bool operator==(const BitBoard& other) const
+		{
+			uint64_t difference{ 0 };
+			for (int w = 0; w < Words; w++)
+				difference |= words[w] ^ other.words[w];
+			return difference == 0;
+		}
+		bool operator!=(const BitBoard& other) const { return !(*this == other); }
+	};
+}
@@ -0,0 +1,211 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "BitBoard.h"
+#include "NeighborhoodTable.h"
+#include "Pentomino.h"
+#include "PentominoBoard.h"
+#include "PlacementKernel.h"
+#include "SolutionArena.h"
+#include "TranspositionTable.h"
+#include "WideCount.h"
+
+// Board dimensions (width, height) that get their own compile time specialized search kernel.
+// These are the common rectangles of 60 cells, plus the 8x8 board. Their transposes are searched
+// transposed, so they use the same kernels.
+#define PENTOMINO_SPECIALIZED_DIMENSIONS(X)\
+	X(6, 10)\
+	X(5, 12)\
+	X(4, 15)\
+	X(3, 20)\
+	X(8, 8)
+
+namespace Pentominoes
+{
+	struct PlacedPentomino;
+
+	// Smallest instantiated word count that holds a board plus its guard column
+	constexpr int wordsForBoard(int width, int height)
+	{
+		int bits{ (width + 1) * height };
+		return bits <= 64 ? 1 : bits <= 128 ? 2 : bits <= 256 ? 4 : 8;
+	}
+
+	// Backtracking search over a BitBoard representation of the board.
+	// Same search as PentominoSolver (fill the first open cell in row-major order with every
+	// fitting piece, cutting branches with islands that can't be filled), but placements,
+	// overlap tests and island checks are word operations instead of string scans.
+	// Instantiated for 1, 2, 4 and 8 words; pick the smallest that fits() the board.
+	//
+	// Width and Height of 0 give the generic kernel, which reads the dimensions from the board.
+	// Nonzero values specialize the kernel for exactly that board size, so the row stride is a
+	// constant and the flood fill shifts by immediate amounts.
+	//
+	// All candidate placements of the anchor cell are tested against the open cells in one batch by
+	// the selected PlacementKernel, and the search walks the resulting bitmask of fitting candidates.
+	template <int Words, int Width = 0, int Height = 0>
+	class BitBoardSolver
+	{
+	public:
+		using Board = BitBoard<Words>;
+		using Solution = std::vector<PlacedPentomino>;
+		// Receives each solution as it's found, returns false to stop the search
+		using SolutionCallback = std::function<bool(const Solution&)>;
+
+		static constexpr int cWords{ Words };
+		static constexpr bool cIsSpecialized{ Width > 0 && Height > 0 };
+		static constexpr int cMinMemoCells{ 15 }; // States with fewer open cells are cheaper to count than to look up
+		static constexpr int cNodeReportInterval{ 4096 };
+
+		// Returns true if the board, plus one guard column, fits in Words words
+		// and matches the dimensions of a specialized kernel, as given or transposed.
+		// A wide board that only fits as given is left to the generic kernel twice this size when that one
+		// can search it transposed, since the narrower rows more than make up for the wider words.
+		static bool fits(const PentominoBoard& board, bool minimizeRepeats)
+		{
+			if (isTransposed(board, minimizeRepeats))
+				return true;
+			int width{ board.getWidth() };
+			int height{ board.getHeight() };
+			if (!cIsSpecialized && width > height && Words < 8 && (height + 1) * width <= 2 * Board::cBits
+				&& !repeatsFollowOrder(board, minimizeRepeats))
+				return false;
+			return fitsSearch(width, height);
+		}
+		// Boards wider than they are tall are searched transposed when they fit that way, so the first open cell
+		// moves down the shorter side and far fewer partial tilings are alive at once. Solutions are still given
+		// in the board's own orientation. Boards whose solutions depend on the cell order never are.
+		static bool isTransposed(const PentominoBoard& board, bool minimizeRepeats)
+		{
+			return board.getWidth() > board.getHeight() && !repeatsFollowOrder(board, minimizeRepeats)
+				&& fitsSearch(board.getHeight(), board.getWidth());
+		}
+
+		// Without repeats, a board of more than 12 pieces uses some of them twice, and which ones depends on the
+		// order the pieces are placed in: every piece has to be used once before any is used again. Such a board's
+		// solutions are the ones found filling the first open cell in row-major order.
+		static bool repeatsFollowOrder(const PentominoBoard& board, bool minimizeRepeats)
+		{
+			return minimizeRepeats
+				&& std::count(board.mBoard.begin(), board.mBoard.end(), '0') / 5 > Pentomino::cTotalBasePieces;
+		}
+
+		// Precondition: fits(board, minimizeRepeats) == true
+		BitBoardSolver(const PentominoBoard& board, bool minimizeRepeats, PlacementKernel kernel = PlacementKernel::Auto);
+
+		// Search every branch starting with the given piece in the first open cell.
+		// Nothing is allocated during the search except blocks of solution storage.
+		void searchFrom(const Pentomino& firstPiece);
+		// Search every branch, stopping early if the solution callback asks to
+		void searchAll();
+		// Same solutions as searchFrom(), but only branches with solutions below them are walked. The count of each
+		// branch is looked up in the table, or counted into it if it's missing, so once the table holds the counts
+		// the search visits little more than the states of the solutions themselves.
+		void searchFrom(const Pentomino& firstPiece, TranspositionTable<Words>& table);
+		// Count the branches starting with the given piece instead of listing their solutions,
+		// reusing the counts of states already in the table
+		WideCount countFrom(const Pentomino& firstPiece, TranspositionTable<Words>& table);
+		// Place pieces one branch at a time, each branch picked with probability proportional to the number of
+		// solutions below it, so every solution is equally likely. The counts come from the table, so later
+		// samples mostly look up states counted by earlier ones. Leaves the solver as it was.
+		// Returns false if the board has no solution.
+		bool sample(TranspositionTable<Words>& table, std::mt19937_64& random, Solution& solution);
+		int64_t getSolutionCount() const { return mSolutions.size(); }
+		// Precondition: 0 <= i < getSolutionCount()
+		void getSolution(int64_t i, Solution& solution) const;
+
+		// Solutions go to the callback instead of getSolution()
+		void setSolutionCallback(SolutionCallback callback) { mOnSolution = std::move(callback); }
+		// Shared flag that stops the search when set, to stop several solvers at once
+		void setStopFlag(const std::atomic<bool>* stop) { mStopFlag = stop; }
+		bool isStopped() const { return mStopped || (mStopFlag && mStopFlag->load(std::memory_order_relaxed)); }
+		// Shared counter of states visited, added to every cNodeReportInterval states and when searchFrom() returns
+		void setNodeCounter(std::atomic<int64_t>* nodes) { mNodeCounter = nodes; }
+		// Bit o is set if PieceOrientation o fits with its first cell on the first open cell, so searchFrom() of any
+		// other orientation finds nothing
+		uint64_t getFirstOrientations() const;
+
+		// Returns false if any island of open cells can't be filled with pentominoes: its area isn't a multiple of 5,
+		// or it has more cells of one checkerboard color than the pieces still available can cover
+		bool isPossibleSolution() const;
+		// Open cells covered by at least one candidate placement. Any other open cell can never be filled.
+		Board getCoverage() const;
+		const Board& getOpenCells() const { return mFree; }
+
+	private:
+		// A piece orientation placed with its first cell on a particular anchor cell.
+		// Only placements that stay on the board and off the walls are generated.
+		struct Candidate
+		{
+			Board mask{};
+			PieceOrientation orientation{};
+			int8_t base{};
+			// Same placement on the board as given, which differs from the searched one when it's transposed
+			PieceOrientation boardOrientation{};
+			int8_t x{};
+			int8_t y{};
+		};
+
+		// Candidate placements for every anchor cell, shared by all copies of a solver
+		struct CandidateTable
+		{
+			std::vector<Candidate> candidates{};
+			std::vector<int> firstCandidate{}; // Candidates for cell i are [firstCandidate[i], firstCandidate[i + 1])
+			std::vector<uint64_t> masks{};     // Candidate masks of each cell in the layout expected by FitTest
+			std::vector<int> firstMask{};      // Offset of cell i's masks
+			std::vector<uint64_t> validOrientations{}; // Bit o of cell i is set if orientation o is a candidate there
+		};
+
+		Board mFree{};              // Open cells not yet covered
+		Board mBlackCells{};        // Cells with an even row + column, for the checkerboard coloring
+		std::shared_ptr<const CandidateTable> mCandidates{};
+		FitTest mFitTest{};
+		const NeighborhoodTable* mNeighborhoodTable{}; // Used instead of mFitTest by the Neighborhood kernel
+		int mWidth{};  // Of the searched board, transposed or not
+		int mHeight{};
+		bool mTransposed{};
+		bool mMinimizeRepeats{};
+		bool mRepeatsFollowOrder{}; // Every count fills the first open cell too, see repeatsFollowOrder()
+		int mPieceCounts[Pentomino::cTotalBasePieces]{};
+		std::vector<const Candidate*> mPlaced{};
+		SolutionArena<const Candidate*> mSolutions{}; // Placements of each solution, in placement order
+		Solution mSolutionBuffer{};                    // Reused for every solution passed to the callback
+		SolutionCallback mOnSolution{};
+		bool mStopped{};
+		const std::atomic<bool>* mStopFlag{};
+		std::atomic<int64_t>* mNodeCounter{};
+		int mUnreportedNodes{};
+
+		static bool fitsSearch(int width, int height)
+		{
+			if (cIsSpecialized)
+				return width == Width && height == Height;
+			return (width + 1) * height <= Board::cBits;
+		}
+
+		int getWidth() const { return cIsSpecialized ? Width : mWidth; }
+		int getHeight() const { return cIsSpecialized ? Height : mHeight; }
+		int getStride() const { return getWidth() + 1; } // Includes the guard column
+
+		void buildCandidates();
+		void search();
+		void search(TranspositionTable<Words>& table);
+		uint64_t findFitting(int cell) const;
+		bool tryPlace(const Candidate& candidate);
+		void removeLast();
+		bool isPieceAvailable(int base) const;
+		void recordSolution();
+		void reportNodes();
+		bool isPossibleSolution(Board& smallestIsland) const;
+		WideCount count(TranspositionTable<Words>& table);
+		WideCount countIslands(TranspositionTable<Words>& table);
+		uint32_t getUsedPieces() const;
+		Board findIsland(const Board& seed, const Board& open) const;
+		void decodeSolution(const Candidate* const* placed, Solution& solution) const;
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "PentominoBoard.h"
+
+namespace Pentominoes
+{
+	// Reads boards in the same format as promptUserInputBoard(): lines of 0s (holes) and other
+	// characters (walls), with a blank line after each board. Every board is read in one pass into
+	// its trimmed grid, without modifying or copying the input, so it can point into a mapped file.
+	class BoardParser
+	{
+	public:
+		// The data has to outlive the parser
+		BoardParser(const char* data, std::size_t size)
+			: mCursor{ data }, mEnd{ data + size } {}
+
+		// Parse the next board into board. Returns false if there are no boards left.
+		bool next(PentominoBoard& board);
+
+		static std::vector<PentominoBoard> parseAll(const char* data, std::size_t size);
+
+	private:
+		struct Line
+		{
+			const char* start;
+			int length;
+		};
+
+		const char* mCursor{};
+		const char* mEnd{};
+		std::vector<Line> mLines{}; // Lines of the current board, reused between boards
+	};
+
+	// Read-only view of a whole file, memory mapped so boards can be parsed in place
+	class MappedFile
+	{
+	public:
+		MappedFile() {}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile();
+
+		// Returns false if the file can't be opened or mapped
+		bool open(const std::string& path);
+		void close();
+		const char* getData() const { return mData; }
+		std::size_t getSize() const { return mSize; }
+
+	private:
+		const char* mData{ nullptr };
+		std::size_t mSize{};
+#if defined(_WIN32)
+		void* mFile{ nullptr };
+		void* mMapping{ nullptr };
+#endif
+	};
+
+	// Every board in the file, or an empty vector if it can't be read
+	std::vector<PentominoBoard> loadBoardFile(const std::string& path);
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "BitBoard.h"
+
+namespace Pentominoes
+{
+	// The 8 symmetries of a rectangle, some of which only apply to square boards
+	enum class BoardTransform : uint8_t
+	{
+		Identity,
+		Rotate90,            // Clockwise
+		Rotate180,
+		Rotate270,           // Clockwise, same as 90 counterclockwise
+		ReflectHorizontal,   // Across the horizontal axis, the top row becomes the bottom row
+		ReflectVertical,     // Across the vertical axis, the left column becomes the right column
+		ReflectDiagonal,     // Across the main diagonal (transpose)
+		ReflectAntidiagonal
+	};
+
+	constexpr int cTotalBoardTransforms{ 8 };
+
+	// Returns true if the transform turns a width x height board into a height x width board
+	constexpr bool swapsDimensions(BoardTransform transform)
+	{
+		return transform == BoardTransform::Rotate90 || transform == BoardTransform::Rotate270
+			|| transform == BoardTransform::ReflectDiagonal || transform == BoardTransform::ReflectAntidiagonal;
+	}
+
+	// Transform that undoes the given one
+	constexpr BoardTransform getInverse(BoardTransform transform)
+	{
+		return transform == BoardTransform::Rotate90 ? BoardTransform::Rotate270
+			: transform == BoardTransform::Rotate270 ? BoardTransform::Rotate90 : transform;
+	}
+
+	// Gather map that applies a transform to a row-major array of one char per cell
+	class CellTransform
+	{
+	public:
+		CellTransform(BoardTransform transform, int width, int height);
+
+		int getWidth() const { return mWidth; }   // Width after the transform
+		int getHeight() const { return mHeight; } // Height after the transform
+		// Cell of the original board that ends up in cell i
+		int getSource(int i) const { return mSource[i]; }
+
+		// Precondition: source and destination hold width * height cells and don't overlap
+		void apply(const char* source, char* destination) const
+		{
+			for (int i = 0; i < static_cast<int>(mSource.size()); i++)
+				destination[i] = source[mSource[i]];
+		}
+
+	private:
+		std::vector<int> mSource{};
+		int mWidth{};
+		int mHeight{};
+	};
+
+	// Rename the pieces of a solution to 'A', 'B', ... in order of first appearance, leaving '0' and '1' alone.
+	// Two solutions with the same cells after relabeling are the same tiling.
+	void relabelCells(char* cells, int count);
+
+	namespace Detail
+	{
+		// BitBoards here are laid out like BitBoardSolver: row-major with stride width + 1
+
+		// Reverse each row in chunks of up to 32 cells, the chunk at column c of length n lands at width - c - n
+		template <int Words>
+		BitBoard<Words> reflectColumns(const BitBoard<Words>& board, int width, int height)
+		{
+			int stride{ width + 1 };
+			BitBoard<Words> result{};
+			for (int row = 0; row < height; row++)
+			{
+				for (int col = 0; col < width; col += 32)
+				{
+					int length{ width - col < 32 ? width - col : 32 };
+					uint64_t bits{ reverseBits64(board.extractBits(row * stride + col, length)) >> (64 - length) };
+					result.depositBits(row * stride + width - col - length, length, bits);
+				}
+			}
+			return result;
+		}
+
+		template <int Words>
+		BitBoard<Words> reflectRows(const BitBoard<Words>& board, int width, int height)
+		{
+			int stride{ width + 1 };
+			BitBoard<Words> result{};
+			for (int row = 0; row < height; row++)
+			{
+				for (int col = 0; col < width; col += 32)
+				{
+					int length{ width - col < 32 ? width - col : 32 };
+					result.depositBits((height - 1 - row) * stride + col, length, board.extractBits(row * stride + col, length));
+				}
+			}
+			return result;
+		}
+
+		// Transpose 8x8 blocks of cells at a time, the result is height cells wide
+		template <int Words>
+		BitBoard<Words> transpose(const BitBoard<Words>& board, int width, int height)
+		{
+			int stride{ width + 1 };
+			int resultStride{ height + 1 };
+			BitBoard<Words> result{};
+			for (int blockRow = 0; blockRow < height; blockRow += 8)
+			{
+				for (int blockCol = 0; blockCol < width; blockCol += 8)
+				{
+					int rows{ height - blockRow < 8 ? height - blockRow : 8 };
+					int cols{ width - blockCol < 8 ? width - blockCol : 8 };
+					uint64_t block{ 0 };
+					for (int r = 0; r < rows; r++)
+						block |= board.extractBits((blockRow + r) * stride + blockCol, cols) << (8 * r);
+					block = transpose8x8(block);
+					// Row c of the transposed block is column c of the original
+					for (int c = 0; c < cols; c++)
+						result.depositBits((blockCol + c) * resultStride + blockRow, rows, block >> (8 * c));
+				}
+			}
+			return result;
+		}
+	}
+
+	// Apply a transform to a width x height BitBoard with a guard column after each row.
+	// Precondition: the transformed board, with its own guard column, also fits in Words words
+	template <int Words>
+	BitBoard<Words> transformBitBoard(const BitBoard<Words>& board, BoardTransform transform, int width, int height)
+	{
+		switch (transform)
+		{
+		case BoardTransform::Rotate90:
+			return Detail::reflectColumns(Detail::transpose(board, width, height), height, width);
+		case BoardTransform::Rotate180:
+			return Detail::reflectRows(Detail::reflectColumns(board, width, height), width, height);
+		case BoardTransform::Rotate270:
+			return Detail::reflectRows(Detail::transpose(board, width, height), height, width);
+		case BoardTransform::ReflectHorizontal:
+			return Detail::reflectRows(board, width, height);
+		case BoardTransform::ReflectVertical:
+			return Detail::reflectColumns(board, width, height);
+		case BoardTransform::ReflectDiagonal:
+			return Detail::transpose(board, width, height);
+		case BoardTransform::ReflectAntidiagonal:
+			return Detail::reflectRows(Detail::reflectColumns(Detail::transpose(board, width, height), height, width), height, width);
+		default:
+			return board;
+		}
+	}
+}
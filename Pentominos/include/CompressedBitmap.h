@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Pentominoes
+{
+	// Set of 32-bit ids, stored the way Roaring bitmaps store them: ids are grouped by their upper 16 bits
+	// into chunks, and each chunk keeps the lower 16 bits as a sorted array while it has at most
+	// cMaxArraySize of them, or as a bitset of all 65536 once it has more. Sparse sets cost 2 bytes an id
+	// and dense ones 1 bit, and intersections only visit chunks present in both sets.
+	class CompressedBitmap
+	{
+	public:
+		static constexpr int cMaxArraySize{ 4096 }; // Past this an array takes more room than a bitset
+
+		// Precondition: id is larger than every id already in the set
+		void append(uint32_t id);
+		bool contains(uint32_t id) const;
+		int64_t size() const;
+		bool isEmpty() const { return mChunks.empty(); }
+		std::size_t getBytes() const;
+		// Every id in increasing order
+		std::vector<uint32_t> toVector() const;
+
+		CompressedBitmap& operator&=(const CompressedBitmap& other);
+		CompressedBitmap& operator|=(const CompressedBitmap& other);
+		friend CompressedBitmap operator&(CompressedBitmap a, const CompressedBitmap& b) { return a &= b; }
+		friend CompressedBitmap operator|(CompressedBitmap a, const CompressedBitmap& b) { return a |= b; }
+
+	private:
+		static constexpr int cBitsetWords{ 1 << 10 };
+
+		// Either array or bits is in use, never both
+		struct Chunk
+		{
+			uint16_t key{};               // Upper 16 bits of every id in the chunk
+			int32_t count{};
+			std::vector<uint16_t> array{}; // Sorted
+			std::vector<uint64_t> bits{};  // cBitsetWords words
+
+			bool isBitset() const { return !bits.empty(); }
+			bool contains(uint16_t low) const;
+			void toBitset();
+			void toArrayIfSmall();
+		};
+
+		std::vector<Chunk> mChunks{}; // Sorted by key, none empty
+
+		static Chunk intersect(const Chunk& a, const Chunk& b);
+		static Chunk unite(const Chunk& a, const Chunk& b);
+	};
+}
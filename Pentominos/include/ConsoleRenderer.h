@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace Pentominoes
+{
+	// Formats boards into text buffers and writes each buffer with a single call.
+	// Pieces and walls are drawn as colored blocks with ANSI escapes when the output is a terminal,
+	// and as plain characters (piece letters, 1s and 0s) when it's redirected.
+	class ConsoleRenderer
+	{
+	public:
+		static const ConsoleRenderer& get();
+
+		bool usesColor() const { return mUseColor; }
+		int getColumns() const { return mColumns; } // Width of the terminal, 80 if unknown
+
+		// Append one row of a board, without a new line.
+		// Precondition: cells holds width * (row + 1) or more cells, row by row
+		void appendLine(std::string& out, const std::string& cells, int width, int row) const;
+		void printBoard(const std::string& cells, int width, int height) const;
+		// Print the boards side by side in as many columns as fit on the terminal.
+		// Large sets are formatted a page at a time on several threads and written in order.
+		// Precondition: every board is width x height
+		void printBoards(const std::vector<const std::string*>& boards, int width, int height) const;
+
+		// Write the buffer to stdout in one call, after anything already written through std::cout
+		static void write(const std::string& buffer);
+
+	private:
+		static constexpr int cRowsPerPage{ 32 }; // Rows of boards formatted by each thread at a time
+
+		bool mUseColor{};
+		int mColumns{ 80 };
+
+		ConsoleRenderer();
+		void formatRows(std::string& out, const std::vector<const std::string*>& boards, int firstRow, int lastRow,
+			int boardsPerRow, int width, int height) const;
+	};
+}
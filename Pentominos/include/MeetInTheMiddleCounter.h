@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "PentominoBoard.h"
+#include "SweepLayout.h"
+#include "WideCount.h"
+
+namespace Pentominoes
+{
+	// Counts solutions by cutting the board in two between a pair of columns and
+	// enumerating partial tilings of each half separately.
+	// Pieces belong to the half containing their anchor, so pieces from the left half
+	// may cross the cut while pieces from the right half never do. Each partial tiling
+	// is recorded by its signature: the cells past the cut covered by the left half (or left
+	// uncovered by the right half), and the set of base pieces it used. Matching signatures
+	// are then joined, checking that the piece sets are disjoint when repeats aren't allowed.
+	class MeetInTheMiddleCounter
+	{
+	public:
+		// Without repeats each base piece is used at most once
+		static constexpr int cMaxNoRepeatCells{ Pentomino::cTotalBasePieces * 5 };
+
+		MeetInTheMiddleCounter(const PentominoBoard& board, bool minimizeRepeats);
+
+		bool canCount() const;
+		// Precondition: canCount() == true
+		WideCount count(bool multithreading);
+		int getCutColumn() const { return mCut; }
+
+	private:
+		static constexpr int cPieceSetBits{ Pentomino::cTotalBasePieces };
+		static constexpr int cSkipCell{ -1 }; // Choice used by the right half to leave a cell for the left half
+
+		// Signature key (crossing cells << cPieceSetBits | piece set) to number of partial tilings
+		using SignatureCounts = std::unordered_map<uint64_t, WideCount>;
+
+		struct HalfState
+		{
+			std::vector<bool> covered{};
+			uint64_t crossing{}; // Cells past the cut covered by the left half
+			int pieceSet{};
+		};
+
+		SweepLayout mLayout;
+		bool mMinimizeRepeats{};
+		int mCut{};       // First column of the right half
+		int mCutCell{};   // First cell of the right half
+		int mZoneCells{}; // Cells past the cut that left half pieces can reach
+		// Every prefix of a left half crossing mask, keyed by (prefix length << 48 | prefix).
+		// Lets the right half discard partial tilings no left half can complete.
+		std::unordered_set<uint64_t> mCrossingPrefixes{};
+
+		int chooseCut() const;
+		SignatureCounts countHalf(bool isRight, bool multithreading) const;
+		void searchHalf(HalfState& state, int cell, bool isRight, SignatureCounts& signatures) const;
+		int findNextCell(const HalfState& state, int cell, bool isRight) const;
+		bool applyChoice(HalfState& state, int cell, int choice, bool isRight) const;
+		void undoChoice(HalfState& state, int cell, int choice) const;
+		bool isConsistentPrefix(int length, uint64_t crossing) const;
+		void buildCrossingPrefixes(const SignatureCounts& leftSignatures);
+		uint64_t makeKey(uint64_t crossing, int pieceSet) const;
+	};
+}
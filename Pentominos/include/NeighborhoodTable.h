@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "BitBoard.h"
+#include "PentominoData.h"
+
+namespace Pentominoes
+{
+	// Lookup table from the open cells around an anchor cell to the orientations that fit there.
+	// The anchor is the first open cell in row-major order, so an orientation placed on it can only
+	// reach the window below: the 4 cells to its right and 4 rows underneath.
+	// The window is split in two indices, rows 0-1 (11 bits) and rows 2-4 (9 bits), so both tables
+	// together take 20KB instead of the 8MB a single 20 bit index would need.
+	class NeighborhoodTable
+	{
+	public:
+		static constexpr int cRows{ 5 };
+		static constexpr int cUpperRows{ 2 };
+		static constexpr int cRowFirstDx[cRows]{ 1, -3, -2, -1, 0 }; // Column of each row's first cell, relative to the anchor
+		static constexpr int cRowWidth[cRows]{ 4, 7, 5, 3, 1 };
+		static constexpr int cUpperBits{ 11 };
+		static constexpr int cLowerBits{ 9 };
+
+		static const NeighborhoodTable& get();
+
+		// Bit o is set if PieceOrientation o fits with its first cell on the anchor.
+		// Cells above or below the board read as closed (0), but a window row reaching more than one cell past
+		// the side of the board wraps onto the row beside it, so the result still has to be masked by the
+		// orientations that stay on the board at this anchor.
+		template <int Words>
+		uint64_t findFitting(const BitBoard<Words>& open, int anchor, int stride) const
+		{
+			uint32_t index[2]{};
+			int shift[2]{};
+			for (int row = 0; row < cRows; row++)
+			{
+				int part{ row < cUpperRows ? 0 : 1 };
+				uint64_t bits{ open.extractBits(anchor + row * stride + cRowFirstDx[row], cRowWidth[row]) };
+				index[part] |= static_cast<uint32_t>(bits) << shift[part];
+				shift[part] += cRowWidth[row];
+			}
+			return mUpper[index[0]] & mLower[index[1]];
+		}
+
+	private:
+		std::vector<uint64_t> mUpper{};
+		std::vector<uint64_t> mLower{};
+
+		NeighborhoodTable();
+	};
+
+	namespace Detail
+	{
+		// Every cell of every orientation, other than the anchor, lies inside the window
+		constexpr bool isCoveredByNeighborhood()
+		{
+			for (const OrientationData& data : cOrientationTable.orientations)
+			{
+				for (const PieceCell& cell : data.cells)
+				{
+					int dx{ cell.x - data.xOffset };
+					if (cell.y == 0 && dx == 0)
+						continue;
+					if (cell.y >= NeighborhoodTable::cRows || dx < NeighborhoodTable::cRowFirstDx[cell.y]
+						|| dx >= NeighborhoodTable::cRowFirstDx[cell.y] + NeighborhoodTable::cRowWidth[cell.y])
+						return false;
+				}
+			}
+			return true;
+		}
+	}
+	static_assert(Detail::isCoveredByNeighborhood(), "Neighborhood window misses a piece cell");
+}
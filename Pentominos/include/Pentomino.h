@@ -1,13 +1,16 @@
-#include <array>
+#pragma once
+#include <cstdint>
 #include <string>
+#include <type_traits>
+
+#include "PentominoData.h"
 
-#pragma once
 namespace Pentominoes
 {
 	// Enum for identifying all 63 unique pentomino orientations
 	// Number suffix denotes the number of 90 degree clockwise rotations applied
 	// M indicates that this is the reflection of the named piece
-	enum class PieceOrientation
+	enum class PieceOrientation : uint8_t
 	{
 		F0,  F1,  F2,  F3, // 0-39: 8x unique orientations (4 rotations x 2 reflections)
 		FM0, FM1, FM2, FM3,
@@ -47,6 +50,8 @@ namespace Pentominoes
 	};
 	
 
+	// One byte handle to a PieceOrientation. All of the piece data is looked up in
+	// cOrientationTable, which is generated at compile time (see PentominoData.h).
 	class Pentomino
 	{
 	public:
@@ -55,41 +60,53 @@ namespace Pentominoes
 
 
 		Pentomino() = delete;
-		Pentomino(PieceOrientation piece);
+		constexpr Pentomino(PieceOrientation piece) : mOrientation{ piece } {}
 
 		static void printAll();
-		static void removeNewLines(std::string& str); // questionable placement
-		static PieceOrientation getBaseOrientation(OrientationBase base);
-		static int getNumberOfOrientations(OrientationBase base);
+		// Gets the first PieceOrientation that corresponds with the given OrientationBase
+		static constexpr PieceOrientation getBaseOrientation(OrientationBase base)
+		{
+			return static_cast<PieceOrientation>(cOrientationTable.baseFirstOrientation[static_cast<int>(base)]);
+		}
+		static constexpr int getNumberOfOrientations(OrientationBase base)
+		{
+			return cOrientationTable.baseOrientationCount[static_cast<int>(base)];
+		}
 
-		int getXOffset() const { return mXOffset; }
-		int getRectangleWidth() const { return mRectangleWidth; }
-		int getRectangleHeight() const { return mRectangleHeight; }
-		bool hasUniqueReflection() const;
-		const std::string& getDataString() const;
-		const std::string& getLabelString() const;
-		PieceOrientation getOrientation() const { return mOrientation; }
-		OrientationBase getBasePiece() const;
-		Pentomino getRotated90() const;
-		Pentomino getRotated180() const;
-		Pentomino getReflection() const;
+		constexpr int getXOffset() const { return getData().xOffset; }
+		constexpr int getRectangleWidth() const { return getData().width; }
+		constexpr int getRectangleHeight() const { return getData().height; }
+		constexpr bool hasUniqueReflection() const { return getData().hasUniqueReflection; }
+		// Cells covered by the piece, relative to the top left of its rectangle, sorted row by row
+		constexpr const PieceCell (&getCells() const)[5] { return getData().cells; }
+		std::string getDataString() const;
+		const char* getLabelString() const;
+		constexpr PieceOrientation getOrientation() const { return mOrientation; }
+		constexpr OrientationBase getBasePiece() const { return static_cast<OrientationBase>(getData().base); }
+		constexpr Pentomino getRotated90() const { return Pentomino(static_cast<PieceOrientation>(getData().rotated90)); }
+		constexpr Pentomino getRotated180() const { return getRotated90().getRotated90(); }
+		// Precondition: hasUniqueReflection() == true
+		constexpr Pentomino getReflection() const { return Pentomino(static_cast<PieceOrientation>(getData().reflection)); }
 
 		// Get the first PieceOrientation associated with this piece's base
-		PieceOrientation getBasePieceOrientation() const { return getBaseOrientation(getBasePiece()); }
+		constexpr PieceOrientation getBasePieceOrientation() const { return getBaseOrientation(getBasePiece()); }
 
-		explicit operator int() const { return static_cast<int>(mOrientation); }
+		constexpr explicit operator int() const { return static_cast<int>(mOrientation); }
 
 	private:
-		static const std::string cOrientationDataStrings[63];
-		static const std::string cOrientationLabelStrings[63]; // mainly for debugging
+		static const char* const cOrientationLabelStrings[63]; // mainly for debugging
 		
 		PieceOrientation mOrientation;
-		int mXOffset;
-		int mRectangleWidth{};
-		int mRectangleHeight{};
 
-		
+		constexpr const OrientationData& getData() const { return cOrientationTable.orientations[static_cast<int>(mOrientation)]; }
 		void print() const;
 		
 	};
-}
\ No newline at end of file
+
+	static_assert(sizeof(Pentomino) == 1 && std::is_trivially_copyable<Pentomino>::value,
+		"Pentomino should be a one byte handle");
+	static_assert(Pentomino(PieceOrientation::F0).getRotated90().getOrientation() == PieceOrientation::F1
+		&& Pentomino(PieceOrientation::Z1).getReflection().getOrientation() == PieceOrientation::ZM1
+		&& Pentomino(PieceOrientation::I1).getRotated90().getOrientation() == PieceOrientation::I0,
+		"Orientation table doesn't match the PieceOrientation layout");
+}
@@ -2,9 +2,8 @@
 #include <string>
 #include <vector>
 #include <stdlib.h>
-#include <windows.h>
-#include <wincon.h>
 
+#include "BoardTransform.h"
 #include "Pentomino.h"
 
 namespace Pentominoes
@@ -29,9 +28,18 @@ namespace Pentominoes
 		static constexpr int cMaskSymmetry180		 { 0x08 };
 
 		friend class PentominoSolver;
+		friend class SweepLayout;
+		friend class SolutionCanonicalizer;
+		friend class SolutionPipeline;
+		friend class SelfCheck;
+		friend class SolutionStatistics;
+		friend class SolverDaemon;
+		template <int Words, int Width, int Height> friend class BitBoardSolver;
 		PentominoBoard() {}; // prompt user to input
 		PentominoBoard(const std::string& board)
 			: mBoard{ board } {  }
+		// Precondition: cells holds width * height '0's and '1's, row by row, with no border of only walls
+		PentominoBoard(std::string cells, int width, int height);
 
 		void promptUserInputBoard();
 		// Set lettering of the board to be as it would be if it was a generated solution
@@ -42,34 +50,27 @@ namespace Pentominoes
 		bool compareBoards(PentominoBoard board) const;
 		int getWidth() const { return mWidth; }
 		int getHeight() const { return mHeight; }
-		PentominoBoard getRotated90() const;
+		// Precondition: New lines have been removed
+		PentominoBoard getTransformed(BoardTransform transform) const;
+		PentominoBoard getRotated90() const; // Counterclockwise
 		PentominoBoard getRotated180() const;
 		PentominoBoard getVerticalReflection() const;
 		PentominoBoard getHorizontalReflection() const;
 		PentominoBoard getAntidiagonalReflection() const;
+		// Returns true if the transform maps every wall onto a wall
+		bool isSymmetricUnder(BoardTransform transform) const;
 
 	private:
-		static HANDLE consoleHandle;
+		static constexpr int cSymmetryWords{ 8 }; // Boards up to this many words use bitboard transforms for symmetry
 
 		std::string mBoard{};
 		
 		int mWidth{};
-		int mStrWidth{}; // mWidth+1
 		int mHeight{};
 		int mSymmetry{};
 
 
-		void removeRow(int row);
-		void removeColumn(int col);
-		void rectangularizeBoard();
-		void trimBoard();
-		void removeNewLines();
-		void insertNewLines();
 		void findSymmetry();
-		bool checkHorizontalSymmetry() const;
-		bool checkVerticalSymmetry() const;
-		bool check90Symmetry() const;
-		bool check180Symmetry() const;
 		void replaceChars(char oldChar, char newChar);
 
 		char operator[](int i) const;
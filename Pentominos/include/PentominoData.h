@@ -1,251 +1,61 @@
-#define PENTOMINO_ORIENTATION_STRINGS\
+#pragma once
+#include <cstdint>
+
+// Base shape of each of the 12 pieces, in OrientationBase order.
+// Every other orientation is generated from these at compile time, see buildOrientationTable().
+#define PENTOMINO_BASE_SHAPE_STRINGS\
 /*F*/\
 	"011\n"\
 	"110\n"\
 	"010\n",\
-\
-	"010\n"\
-	"111\n"\
-	"001\n",\
-\
-	"010\n"\
-	"011\n"\
-	"110\n",\
-\
-	"100\n"\
-	"111\n"\
-	"010\n",\
-/*FM*/\
-	"110\n"\
-	"011\n"\
-	"010\n",\
-\
-	"001\n"\
-	"111\n"\
-	"010\n",\
-\
-	"010\n"\
-	"110\n"\
-	"011\n",\
-\
-	"010\n"\
-	"111\n"\
-	"100\n",\
 /*L*/\
 	"10\n"\
 	"10\n"\
 	"10\n"\
 	"11\n",\
-\
-	"1111\n"\
-	"1000\n",\
-\
-	"11\n"\
-	"01\n"\
-	"01\n"\
-	"01\n",\
-\
-	"0001\n"\
-	"1111\n",\
-/*LM*/\
-	"01\n"\
-	"01\n"\
-	"01\n"\
-	"11\n",\
-\
-	"1000\n"\
-	"1111\n",\
-\
-	"11\n"\
-	"10\n"\
-	"10\n"\
-	"10\n",\
-\
-	"1111\n"\
-	"0001\n",\
 /*N*/\
 	"01\n"\
 	"01\n"\
 	"11\n"\
 	"10\n",\
-\
-	"1100\n"\
-	"0111\n",\
-\
-	"01\n"\
-	"11\n"\
-	"10\n"\
-	"10\n",\
-\
-	"1110\n"\
-	"0011\n",\
-/*NM*/\
-	"10\n"\
-	"10\n"\
-	"11\n"\
-	"01\n",\
-\
-	"0111\n"\
-	"1100\n",\
-\
-	"10\n"\
-	"11\n"\
-	"01\n"\
-	"01\n",\
-\
-	"0011\n"\
-	"1110\n",\
 /*P*/\
 	"11\n"\
 	"11\n"\
 	"10\n",\
-\
-	"111\n"\
-	"011\n",\
-\
-	"01\n"\
-	"11\n"\
-	"11\n",\
-\
-	"110\n"\
-	"111\n", \
-/*PM*/\
-	"11\n"\
-	"11\n"\
-	"01\n",\
-\
-	"011\n"\
-	"111\n",\
-\
-	"10\n"\
-	"11\n"\
-	"11\n",\
-\
-	"111\n"\
-	"110\n",\
 /*Y*/\
 	"01\n"\
 	"11\n"\
 	"01\n"\
-	"01\n", \
-	\
-	"0010\n"\
-	"1111\n", \
-	\
-	"10\n"\
-	"10\n"\
-	"11\n"\
-	"10\n", \
-	\
-	"1111\n"\
-	"0100\n", \
-/*YM*/\
-	"10\n"\
-	"11\n"\
-	"10\n"\
-	"10\n", \
-	\
-	"1111\n"\
-	"0010\n", \
-	\
-	"01\n"\
-	"01\n"\
-	"11\n"\
-	"01\n", \
-	\
-	"0100\n"\
-	"1111\n", \
+	"01\n",\
 /*T*/\
 	"111\n"\
 	"010\n"\
-	"010\n", \
-	\
-	"001\n"\
-	"111\n"\
-	"001\n", \
-	\
-	"010\n"\
-	"010\n"\
-	"111\n", \
-	\
-	"100\n"\
-	"111\n"\
-	"100\n", \
+	"010\n",\
 /*U*/\
-	\
 	"101\n"\
-	"111\n", \
-	\
-	"11\n"\
-	"10\n"\
-	"11\n",\
-	\
-	"111\n"\
-	"101\n", \
-	\
-	"11\n"\
-	"01\n"\
-	"11\n", \
+	"111\n",\
 /*V*/\
 	"100\n"\
 	"100\n"\
-	"111\n", \
-	\
-	"111\n"\
-	"100\n"\
-	"100\n", \
-	\
-	"111\n"\
-	"001\n"\
-	"001\n", \
-	\
-	"001\n"\
-	"001\n"\
-	"111\n", \
+	"111\n",\
 /*W*/\
 	"100\n"\
 	"110\n"\
-	"011\n", \
-	\
-	"011\n"\
-	"110\n"\
-	"100\n", \
-	\
-	"110\n"\
-	"011\n"\
-	"001\n", \
-	\
-	"001\n"\
-	"011\n"\
-	"110\n", \
+	"011\n",\
 /*Z*/\
 	"110\n"\
 	"010\n"\
 	"011\n",\
-	\
-	"001\n"\
-	"111\n"\
-	"100\n",\
-/*ZM*/\
-	"011\n"\
-	"010\n"\
-	"110\n", \
-	\
-	"100\n"\
-	"111\n"\
-	"001\n", \
 /*I*/\
 	"1\n"\
 	"1\n"\
 	"1\n"\
 	"1\n"\
 	"1\n",\
-\
-	"11111\n",\
 /*X*/\
 	"010\n"\
 	"111\n"\
-	"010\n",\
+	"010\n"
 
 
 #define PENTOMINO_LABEL_STRINGS "F0",  "F1",  "F2",  "F3",\
@@ -267,3 +77,191 @@
 								"I0", "I1",\
 								"X0"
 
+namespace Pentominoes
+{
+	// Cell of a piece, relative to the top left corner of its bounding rectangle
+	struct PieceCell
+	{
+		int8_t x{};
+		int8_t y{};
+	};
+
+	// Everything known about one PieceOrientation, indexed by the enum value
+	struct OrientationData
+	{
+		PieceCell cells[5]{}; // Sorted row by row, so cells[0] is the leftmost cell of the top row
+		int8_t width{};
+		int8_t height{};
+		int8_t xOffset{};     // Column of the first cell in the top row
+		int8_t base{};        // OrientationBase
+		int8_t rotated90{};   // PieceOrientation after a 90 degree clockwise rotation
+		int8_t reflection{};  // Reflected PieceOrientation with the same number of rotations applied
+		bool hasUniqueReflection{}; // Reflection isn't just a rotation of this orientation
+	};
+
+	struct OrientationTable
+	{
+		OrientationData orientations[63]{};
+		int8_t baseFirstOrientation[12]{};
+		int8_t baseOrientationCount[12]{};
+	};
+
+	namespace Detail
+	{
+		struct Shape
+		{
+			PieceCell cells[5]{};
+			int8_t width{};
+			int8_t height{};
+		};
+
+		// Shift the cells to the top left corner, sort them row by row and measure the bounding rectangle
+		constexpr Shape normalize(Shape shape)
+		{
+			int minX{ shape.cells[0].x };
+			int minY{ shape.cells[0].y };
+			int maxX{ minX };
+			int maxY{ minY };
+			for (const PieceCell& cell : shape.cells)
+			{
+				minX = cell.x < minX ? cell.x : minX;
+				minY = cell.y < minY ? cell.y : minY;
+				maxX = cell.x > maxX ? cell.x : maxX;
+				maxY = cell.y > maxY ? cell.y : maxY;
+			}
+			for (PieceCell& cell : shape.cells)
+			{
+				cell.x = static_cast<int8_t>(cell.x - minX);
+				cell.y = static_cast<int8_t>(cell.y - minY);
+			}
+			for (int i = 1; i < 5; i++)
+			{
+				for (int j = i; j > 0; j--)
+				{
+					PieceCell& a{ shape.cells[j - 1] };
+					PieceCell& b{ shape.cells[j] };
+					if (a.y > b.y || (a.y == b.y && a.x > b.x))
+					{
+						PieceCell temp{ a };
+						a = b;
+						b = temp;
+					}
+				}
+			}
+			shape.width = static_cast<int8_t>(maxX - minX + 1);
+			shape.height = static_cast<int8_t>(maxY - minY + 1);
+			return shape;
+		}
+
+		constexpr Shape parseShape(const char* str)
+		{
+			Shape shape{};
+			int next{ 0 };
+			int x{ 0 };
+			int y{ 0 };
+			for (; *str; str++)
+			{
+				if (*str == '\n')
+				{
+					x = 0;
+					y++;
+					continue;
+				}
+				if (*str == '1')
+					shape.cells[next++] = PieceCell{ static_cast<int8_t>(x), static_cast<int8_t>(y) };
+				x++;
+			}
+			return normalize(shape);
+		}
+
+		constexpr Shape rotate90(Shape shape)
+		{
+			for (PieceCell& cell : shape.cells)
+				cell = PieceCell{ static_cast<int8_t>(-cell.y), cell.x };
+			return normalize(shape);
+		}
+
+		constexpr Shape reflect(Shape shape)
+		{
+			for (PieceCell& cell : shape.cells)
+				cell.x = static_cast<int8_t>(-cell.x);
+			return normalize(shape);
+		}
+
+		// Precondition: both shapes are normalized
+		constexpr bool isSameShape(const Shape& a, const Shape& b)
+		{
+			for (int i = 0; i < 5; i++)
+			{
+				if (a.cells[i].x != b.cells[i].x || a.cells[i].y != b.cells[i].y)
+					return false;
+			}
+			return true;
+		}
+
+		// Find the orientation of the base piece with the same shape
+		constexpr int findOrientation(const Shape (&shapes)[63], int first, int count, const Shape& shape)
+		{
+			for (int i = first; i < first + count; i++)
+			{
+				if (isSameShape(shapes[i], shape))
+					return i;
+			}
+			return -1;
+		}
+
+		// Generates every orientation in PieceOrientation order: 4 clockwise rotations of the base shape,
+		// followed by the same 4 rotations of its reflection for pieces with a unique reflection.
+		// Z and I only have 2 unique rotations, and X has 1.
+		constexpr OrientationTable buildOrientationTable()
+		{
+			constexpr const char* baseShapeStrings[12]{ PENTOMINO_BASE_SHAPE_STRINGS };
+			constexpr int rotationCounts[12]{ 4, 4, 4, 4, 4, 4, 4, 4, 4, 2, 2, 1 };
+			constexpr bool hasReflection[12]{ true, true, true, true, true, false, false, false, false, true, false, false };
+
+			OrientationTable table{};
+			Shape shapes[63]{};
+			int next{ 0 };
+			for (int base = 0; base < 12; base++)
+			{
+				table.baseFirstOrientation[base] = static_cast<int8_t>(next);
+				Shape shape{ parseShape(baseShapeStrings[base]) };
+				for (int reflected = 0; reflected <= (hasReflection[base] ? 1 : 0); reflected++)
+				{
+					Shape rotated{ reflected ? reflect(shape) : shape };
+					for (int rotation = 0; rotation < rotationCounts[base]; rotation++)
+					{
+						shapes[next] = rotated;
+						table.orientations[next].base = static_cast<int8_t>(base);
+						table.orientations[next].hasUniqueReflection = hasReflection[base];
+						next++;
+						rotated = rotate90(rotated);
+					}
+				}
+				table.baseOrientationCount[base] = static_cast<int8_t>(next - table.baseFirstOrientation[base]);
+			}
+
+			for (int i = 0; i < 63; i++)
+			{
+				OrientationData& data{ table.orientations[i] };
+				int first{ table.baseFirstOrientation[data.base] };
+				int count{ table.baseOrientationCount[data.base] };
+				for (int j = 0; j < 5; j++)
+					data.cells[j] = shapes[i].cells[j];
+				data.width = shapes[i].width;
+				data.height = shapes[i].height;
+				data.xOffset = shapes[i].cells[0].x;
+				data.rotated90 = static_cast<int8_t>(findOrientation(shapes, first, count, rotate90(shapes[i])));
+				// The reflected half of the orientations follows the unreflected half
+				int rotations{ rotationCounts[data.base] };
+				if (!data.hasUniqueReflection)
+					data.reflection = static_cast<int8_t>(i);
+				else
+					data.reflection = static_cast<int8_t>(i < first + rotations ? i + rotations : i - rotations);
+			}
+			return table;
+		}
+	}
+
+	inline constexpr OrientationTable cOrientationTable{ Detail::buildOrientationTable() };
+}
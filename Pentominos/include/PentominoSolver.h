@@ -1,14 +1,23 @@
 #pragma once
 #include <vector>
 #include <chrono>
+#include <memory>
 #include <mutex>
-#include <Windows.h>
 
 #include "Pentomino.h"
 #include "PentominoBoard.h"
+#include "PlacementKernel.h"
+#include "SolutionArena.h"
+#include "SolutionIndex.h"
+#include "SolveJob.h"
+#include "TranspositionTable.h"
+#include "WideCount.h"
 
 namespace Pentominoes
 {
+	class SolutionPipeline;
+	class SolutionStatistics;
+
 	struct PlacedPentomino
 	{
 		Pentomino pentomino;
@@ -18,16 +27,106 @@ namespace Pentominoes
 			: pentomino{ a_pentomino }, position{ a_position }, symbol{ a_symbol } {}
 	};
 
+	// Strategies available to findAllSolutions()
+	enum class SolveStrategy
+	{
+		Backtrack,           // Enumerate and store every solution
+		CountTransferMatrix, // Count only, by sweeping frontier profiles. Repeats mode on boards up to 12 cells across.
+		CountMeetInTheMiddle, // Count only, by joining partial tilings of two halves of the board. Boards up to 12 cells across.
+		CountMemoized,       // Count only, by backtracking and reusing the counts of states reached by several placement orders
+		CheckUniqueness      // Stop at the second solution that isn't a symmetry of the first, see getUniquenessLastSolution()
+	};
+
+	// Number of solutions up to symmetries of the board
+	enum class Uniqueness
+	{
+		NoSolution,
+		Unique,
+		Multiple
+	};
+
 	class PentominoSolver
 	{
+		friend class SelfCheck;
 	public:
-		static void findAllSolutions(const PentominoBoard& board, bool minimizeRepeats, bool multithreading = false);
+		static void findAllSolutions(const PentominoBoard& board, bool minimizeRepeats, bool multithreading = false,
+			SolveStrategy strategy = SolveStrategy::Backtrack);
 		static std::chrono::duration<double> getDurationLastSolution()
 		{
 			return durationLastSolution;
 		}
+		// Number of solutions found by the last call to findAllSolutions(), before removing trivial solutions
+		static WideCount getCountLastSolution()
+		{
+			return countLastSolution;
+		}
+		// Counts the solutions with one of the count strategies, without printing anything or touching the solutions of
+		// the last search. Returns false if the strategy doesn't apply to the board, otherwise getCountLastSolution() gives
+		// the count.
+		static bool countSolutions(const PentominoBoard& board, bool minimizeRepeats, SolveStrategy strategy, bool multithreading = true);
+		// Kernel used by the bitboard search to test candidate placements.
+		// Returns false and keeps the current kernel if the CPU doesn't support it.
+		static bool setPlacementKernel(PlacementKernel kernel);
+		static PlacementKernel getPlacementKernel()
+		{
+			return placementKernel;
+		}
+		// Memory for the table of states used by SolveStrategy::CountMemoized, and for the one findSolutionsAfterEdit()
+		// keeps once it starts over
+		static void setTranspositionTableSize(std::size_t bytes)
+		{
+			transpositionTableBytes = bytes;
+		}
+		// Lookups and hits of the last call to findAllSolutions() with SolveStrategy::CountMemoized, or of the table kept
+		// by findSolutionsAfterEdit()
+		static TranspositionStats getTranspositionStatsLastSolution()
+		{
+			return transpositionStatsLastSolution;
+		}
+		// Result of the last call to findAllSolutions() with SolveStrategy::CheckUniqueness
+		static Uniqueness getUniquenessLastSolution()
+		{
+			return uniquenessLastSolution;
+		}
+		// Same solutions as findAllSolutions() followed by removeTrivialSolutions(), in the same order, but the trivial
+		// solutions are removed on other threads while the search is running instead of afterwards.
+		// With print, each row of solutions is printed as soon as it's complete.
+		static void findUniqueSolutions(const PentominoBoard& board, bool minimizeRepeats, bool multithreading = false,
+			bool print = false);
+		// Starts a search for every solution on the ThreadPool and returns without waiting for it.
+		// Unlike the blocking calls, nothing is printed and the static results of the last solution are left alone.
+		static std::shared_ptr<SolveJob> solveAsync(const SolveRequest& request);
+		// Draws samples solutions uniformly at random, with replacement, and keeps them as the solutions of the last
+		// search in the order drawn. Every solution is counted first, so this works on boards far too large to enumerate
+		// as long as the count fits the transposition table well. Sample i depends only on the seed and i, so a seed
+		// gives the same samples on every run and with any number of threads. getCountLastSolution() gives the number
+		// of solutions the samples were drawn from. Returns false if the board is too large for the bitboard search.
+		static bool sampleSolutions(const PentominoBoard& board, bool minimizeRepeats, int samples, uint64_t seed = 0,
+			bool multithreading = true);
+		// Adds every solution of the board to statistics as the search finds it, without keeping any of them.
+		// The solutions of the last search are left alone. Returns false if the board is too large for the bitboard search.
+		static bool findStatistics(const PentominoBoard& board, bool minimizeRepeats, SolutionStatistics& statistics,
+			bool multithreading = true);
+		// Same solutions as findAllSolutions(), for an editor that solves again after every change to the board.
+		// The count of every search state is kept between calls. A state is only its open cells and the pieces
+		// already used in the current round, and it's counted in the search's own cell order wherever that order decides
+		// which pieces repeat, so no edit makes its count wrong. The states the search reaches after getting past the
+		// edited cells have mostly been counted by earlier calls. The search only walks branches with solutions below
+		// them, and a board solved by the last call gets its solutions back without searching.
+		// getTranspositionStatsLastSolution() reports the kept table's totals over every call.
+		// Returns false if the board is too large for the bitboard search.
+		static bool findSolutionsAfterEdit(const PentominoBoard& board, bool minimizeRepeats, bool multithreading = true);
+		// Frees what findSolutionsAfterEdit() kept
+		static void clearEditState();
 		static void printSolutions();
 		static void removeTrivialSolutions();
+		// Index of the solutions kept by the last search, the id of each being its position in the list
+		static SolutionIndex indexSolutions();
+		// Precondition: i is less than the number of solutions kept by the last search
+		static const PentominoBoard& getSolution(std::size_t i)
+		{
+			return (*solutionsFound)[i].mBoard;
+		}
 
 
 		PentominoSolver(const PentominoBoard& board, bool minimizeRepeats);
@@ -49,17 +148,49 @@ namespace Pentominoes
 		
 	private:		
 		static std::chrono::duration<double> durationLastSolution;
+		static WideCount countLastSolution;
+		static Uniqueness uniquenessLastSolution;
+		static PlacementKernel placementKernel;
+		static std::size_t transpositionTableBytes;
+		static TranspositionStats transpositionStatsLastSolution;
 		static std::vector<PentominoSolver>* solutionsFound;
-		static std::mutex lock;
+		struct EditState;
+		template <class Solver>
+		struct SolverEditState;
+		static std::unique_ptr<EditState> editState; // Kept by findSolutionsAfterEdit()
 
 		PentominoBoard mBoard{};
 		bool* mPiecesAvailable{nullptr}; // heap allocated bool array, only used when mMinimizeRepeats = true
 		std::vector<PlacedPentomino> mPlacedPentominoes{};
 		bool mMinimizeRepeats{};
 		char mNextSymbol{ 'A' }; // 1-char symbol to represent each instance of a piece in the solution
+		SolutionArena<char> mSolutions{}; // Solved boards found by this searcher
+
+		static void searchStrings(const PentominoBoard& board, bool minimizeRepeats, bool multithreading);
+		static bool dispatchBitBoard(const PentominoBoard& board, bool minimizeRepeats, bool multithreading, bool checkUniqueness,
+			SolutionPipeline* pipeline = nullptr, std::vector<SolutionStatistics>* statistics = nullptr);
+		static bool dispatchCount(const PentominoBoard& board, bool minimizeRepeats, bool multithreading);
+		template <class Solver>
+		static bool countBitBoard(const PentominoBoard& board, bool minimizeRepeats, bool multithreading);
+		template <class Solver>
+		static WideCount countOrientations(const Solver& prototype, TranspositionTable<Solver::cWords>& table, bool multithreading);
+		static bool dispatchSample(const PentominoBoard& board, bool minimizeRepeats, int samples, uint64_t seed, bool multithreading,
+			std::vector<std::string>& cells);
+		template <class Solver>
+		static bool sampleBitBoard(const PentominoBoard& board, bool minimizeRepeats, int samples, uint64_t seed, bool multithreading,
+			std::vector<std::string>& cells);
+		static bool dispatchJob(const SolveRequest& request, const std::shared_ptr<SolveJob>& job);
+		template <class Solver>
+		static bool startJob(const SolveRequest& request, const std::shared_ptr<SolveJob>& job);
+		static bool dispatchEdit(const PentominoBoard& board, bool minimizeRepeats, bool multithreading);
+		template <class Solver>
+		static bool searchAfterEdit(const PentominoBoard& board, bool minimizeRepeats, bool multithreading);
+		template <class Solver>
+		static bool searchBitBoard(const PentominoBoard& board, bool minimizeRepeats, bool multithreading, bool checkUniqueness,
+			SolutionPipeline* pipeline, std::vector<SolutionStatistics>* statistics);
 
-		std::vector<int> findHoleAreas();
 		int findHoleArea(const Point& posHole);
+		void storeSolution();
 		void resetAvailable();
 		void setAvailable(const Pentomino& piece, bool available);
 			
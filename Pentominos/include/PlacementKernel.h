@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+namespace Pentominoes
+{
+	// Implementations of the batch placement test used by BitBoardSolver
+	enum class PlacementKernel
+	{
+		Auto,   // Fastest kernel supported by the CPU
+		Scalar, // Reference implementation, one candidate at a time
+		SSE2,   // 2 candidates per instruction
+		AVX2,   // 4 candidates per instruction
+		Neighborhood // Table lookup from the open cells around the anchor, see NeighborhoodTable
+	};
+
+	// Tests every candidate placement of one anchor cell against the open cells of the board.
+	// Masks are stored word by word: word w of candidate i is masks[w * stride + i], where stride is
+	// count rounded up to a multiple of 4. Bit i of the result is set if candidate i fits on the open cells.
+	// Precondition: count <= 64
+	using FitTest = uint64_t(*)(const uint64_t* masks, int stride, int count, int words, const uint64_t* open);
+
+	// Kernels are padded to this many candidates, the widest vector used
+	constexpr int cPlacementKernelLanes{ 4 };
+
+	bool isPlacementKernelSupported(PlacementKernel kernel);
+	// Replaces Auto with the fastest supported kernel
+	PlacementKernel resolvePlacementKernel(PlacementKernel kernel);
+	// Precondition: isPlacementKernelSupported(kernel) == true, or kernel == Auto.
+	// Neighborhood isn't a batch kernel and gives nullptr.
+	FitTest getFitTest(PlacementKernel kernel);
+	const char* getPlacementKernelName(PlacementKernel kernel);
+}
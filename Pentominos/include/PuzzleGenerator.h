@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "PentominoBoard.h"
+#include "PentominoSolver.h"
+
+namespace Pentominoes
+{
+	struct GeneratorOptions
+	{
+		int width{ 10 };             // Bounding box of the sampled boards
+		int height{ 6 };
+		double wallProbability{ 0.2 }; // Chance of each cell in the box being a wall
+		int64_t samples{ 100000 };   // Number of boards to sample
+		uint64_t seed{ 0 };          // Sample i is the same board for the same seed, whatever the thread count
+		bool minimizeRepeats{ true };
+		int threads{ 0 };            // 0 uses every core
+	};
+
+	// Number of boards that reached and left each stage of the pipeline
+	struct GeneratorStats
+	{
+		int64_t sampled{};
+		int64_t rejectedArea{};      // Number of holes isn't a multiple of 5
+		int64_t rejectedIslands{};   // An island of holes isn't a multiple of 5, or can't balance its checkerboard colors
+		int64_t rejectedDeadCells{}; // A hole no piece placement can cover
+		int64_t solved{};            // Passed every filter and went to the solver
+		int64_t noSolution{};
+		int64_t multipleSolutions{}; // Stopped at the second distinct solution
+		int64_t unique{};
+
+		void print() const;
+	};
+
+	// Samples random boards inside a bounding box and keeps the ones with exactly one solution,
+	// counting solutions that are symmetries of each other on the board as the same solution.
+	// Cheap filters run first, and the solver stops as soon as it finds a second distinct solution.
+	// Each worker thread takes the next sample number and runs it through every stage.
+	class PuzzleGenerator
+	{
+	public:
+		// Receives each board with a unique solution as soon as it's found, from one thread at a time
+		using PuzzleCallback = std::function<void(const PentominoBoard& board, const std::vector<PlacedPentomino>& solution)>;
+
+		explicit PuzzleGenerator(const GeneratorOptions& options)
+			: mOptions{ options } {}
+
+		// Returns false without sampling if the bounding box is too large for the bitboard solver
+		bool run(const PuzzleCallback& onPuzzle);
+		// Counters so far, safe to call from another thread while run() is going
+		GeneratorStats getStats() const;
+
+	private:
+		enum class Stage
+		{
+			Sampled,
+			RejectedArea,
+			RejectedIslands,
+			RejectedDeadCells,
+			Solved,
+			NoSolution,
+			MultipleSolutions,
+			Unique,
+			Total
+		};
+
+		GeneratorOptions mOptions{};
+		std::atomic<int64_t> mNextSample{};
+		std::atomic<int64_t> mCounters[static_cast<int>(Stage::Total)]{};
+
+		std::string sampleBoard(int64_t sample) const;
+		template <int Words>
+		void work(const PuzzleCallback& onPuzzle, std::mutex& outputLock);
+		void count(Stage stage) { mCounters[static_cast<int>(stage)].fetch_add(1, std::memory_order_relaxed); }
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "PentominoBoard.h"
+#include "PentominoSolver.h"
+
+namespace Pentominoes
+{
+	// Checks that the solver's strategies agree on boards where they're easy to get wrong, run with
+	// Pentominos --check. Each check prints one line with its result, and the output of the solves
+	// themselves is hidden.
+	class SelfCheck
+	{
+	public:
+		// Returns true if every check passed
+		static bool runAll();
+
+	private:
+		// Rows of '0' for open cells and '1' for walls, all the same length
+		static PentominoBoard makeBoard(std::initializer_list<const char*> rows);
+		// Cells of each solution kept by the last search, relettered and sorted so searches can be compared
+		static std::vector<std::string> getSolutionCells();
+		static bool report(const std::string& name, bool passed, const std::string& detail);
+
+		static bool checkMemoizedCount(std::initializer_list<const char*> rows, const char* size);
+		static bool checkCounter(std::initializer_list<const char*> rows, bool minimizeRepeats, SolveStrategy strategy,
+			const std::string& name);
+		static bool checkMeetInTheMiddleRefuses();
+		static bool checkStatistics(std::initializer_list<const char*> rows, const char* size);
+		static bool checkKernels();
+		template <int Words>
+		static bool checkTransforms(int maxSide);
+		static bool checkSearchOrder();
+		static bool checkEdits();
+		static bool checkSampling();
+		static bool checkCancel();
+		static bool checkHeldSolutions();
+		static bool checkHeldBatches();
+	};
+}
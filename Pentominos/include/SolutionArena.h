@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace Pentominoes
+{
+	// Append-only storage for fixed-size solution records, kept in large blocks so that storing a
+	// solution only allocates once per block instead of once per solution.
+	// Every solution of a board has the same number of pieces and cells, so one record size fits all.
+	template <class T>
+	class SolutionArena
+	{
+	public:
+		explicit SolutionArena(int recordSize = 1)
+			: mRecordSize{ recordSize > 0 ? recordSize : 1 },
+			mRecordsPerBlock{ cBlockBytes / static_cast<int>(sizeof(T)) / mRecordSize > 0 ? cBlockBytes / static_cast<int>(sizeof(T)) / mRecordSize : 1 } {}
+
+		int getRecordSize() const { return mRecordSize; }
+		int64_t size() const { return mCount; }
+
+		// Space for the next record, to be filled in by the caller
+		T* allocate()
+		{
+			int slot{ static_cast<int>(mCount % mRecordsPerBlock) };
+			if (slot == 0)
+				mBlocks.emplace_back(static_cast<std::size_t>(mRecordsPerBlock) * mRecordSize);
+			++mCount;
+			return mBlocks.back().data() + static_cast<std::size_t>(slot) * mRecordSize;
+		}
+
+		// Precondition: 0 <= i < size()
+		const T* operator[](int64_t i) const
+		{
+			return mBlocks[i / mRecordsPerBlock].data() + static_cast<std::size_t>(i % mRecordsPerBlock) * mRecordSize;
+		}
+
+		void clear()
+		{
+			mBlocks.clear();
+			mCount = 0;
+		}
+
+	private:
+		static constexpr int cBlockBytes{ 1 << 16 };
+
+		int mRecordSize{};
+		int mRecordsPerBlock{};
+		int64_t mCount{};
+		std::vector<std::vector<T>> mBlocks{};
+	};
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "BoardTransform.h"
+#include "PentominoBoard.h"
+
+namespace Pentominoes
+{
+	struct PlacedPentomino;
+
+	// Canonical form of solutions under the symmetries of a board's walls.
+	// A solution's key is the smallest relabeled form among its transformations, so two solutions
+	// get the same key exactly when one is a transformation of the other.
+	class SolutionCanonicalizer
+	{
+	public:
+		explicit SolutionCanonicalizer(const PentominoBoard& board);
+
+		// Transformations other than the identity that map the walls onto themselves
+		const std::vector<CellTransform>& getSymmetries() const { return mSymmetries; }
+
+		// Precondition: cells is a solved copy of the board
+		std::string getKey(const std::string& cells) const;
+		// Key of the solution made by placing the pieces on the board
+		std::string getKey(const std::vector<PlacedPentomino>& placements) const;
+		// Number of symmetries, counting the identity, that map the solution onto itself. The solution has
+		// (getSymmetries().size() + 1) / getStabilizerSize() distinct transformations.
+		// Precondition: cells is a solved copy of the board
+		int getStabilizerSize(const std::string& cells) const;
+
+	private:
+		std::string mBoard{};
+		int mWidth{};
+		std::vector<CellTransform> mSymmetries{};
+	};
+}
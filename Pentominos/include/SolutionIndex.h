@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CompressedBitmap.h"
+#include "Pentomino.h"
+#include "PentominoBoard.h"
+
+namespace Pentominoes
+{
+	struct PlacedPentomino;
+
+	// Inverted index over the solutions of one board: for every placement, an orientation at a position,
+	// the ids of the solutions that contain it. A solution's id is the order it was added in.
+	// Questions about which solutions contain some arrangement of pieces become intersections and unions
+	// of the placements' bitmaps instead of a scan over every solution.
+	class SolutionIndex
+	{
+	public:
+		SolutionIndex(int width, int height);
+
+		// Return the new solution's id
+		uint32_t add(const std::vector<PlacedPentomino>& solution);
+		// Precondition: cells is a solved width x height board, each piece marked with its own symbol
+		uint32_t addSolvedBoard(const std::string& cells);
+
+		int64_t getSolutionCount() const { return mSolutionCount; }
+		std::size_t getBytes() const;
+
+		// Solutions with the piece at the position, the top left of its rectangle as in PlacedPentomino.
+		// Empty for placements off the board.
+		const CompressedBitmap& find(const Pentomino& piece, const Point& position) const;
+		// Solutions containing every placement, answered by intersecting the smallest bitmaps first
+		CompressedBitmap findAll(const std::vector<PlacedPentomino>& placements) const;
+		// Solutions containing at least one of the placements
+		CompressedBitmap findAny(const std::vector<PlacedPentomino>& placements) const;
+		// Solutions with any orientation of the piece covering the cell
+		CompressedBitmap findCovering(OrientationBase piece, const Point& cell) const;
+
+	private:
+		int mWidth{};
+		int mHeight{};
+		int64_t mSolutionCount{};
+		std::vector<CompressedBitmap> mPlacements{}; // Indexed by orientation, then the cell of the rectangle's top left
+		CompressedBitmap mEmpty{};
+
+		void addPlacement(const Pentomino& piece, int x, int y);
+	};
+}
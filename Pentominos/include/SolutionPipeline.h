@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "BitBoard.h"
+#include "PentominoBoard.h"
+#include "SolutionCanonicalizer.h"
+#include "SpscRing.h"
+
+namespace Pentominoes
+{
+	struct PlacedPentomino;
+
+	// Removes trivial solutions while the search is still running.
+	// Each search thread pushes its solutions as compact records into its own ring, and consumer
+	// threads drain the rings, canonicalize each solution, and pass the first solution of each
+	// distinct solution on to the callback. A full ring makes its search thread wait, so memory
+	// between the search and the output stays bounded however many solutions there are.
+	//
+	// Ordered pipelines pass solutions on in the order of a single-threaded search, with producer i searching
+	// the branches that come before those of producer i + 1. Consumers still canonicalize in parallel, but
+	// hold each solution in its producer's buffer until every earlier producer has been passed on. Whichever
+	// consumer is free merges the buffers in producer order and picks the distinct solutions, so the same
+	// solution of each set of symmetric ones is kept on every run. Solutions whose key was already passed
+	// on are dropped before being held. A producer ahead of the one being passed on holds at most cMaxHeld
+	// solutions; after that its ring isn't drained, so its search thread waits until the producers before it
+	// are done and memory stays bounded in this mode too.
+	class SolutionPipeline
+	{
+		friend class SelfCheck;
+	public:
+		// Receives each distinct solution with its solved board, from one consumer thread at a time
+		using UniqueCallback = std::function<void(const std::vector<PlacedPentomino>& solution, const std::string& cells)>;
+
+		// Starts the consumers, each draining every consumers-th ring
+		SolutionPipeline(const PentominoBoard& board, int producers, int consumers, UniqueCallback onUnique,
+			bool ordered = false);
+		~SolutionPipeline();
+
+		// Producer only, from one thread per producer index
+		void push(int producer, const std::vector<PlacedPentomino>& solution);
+		// Producer only: no more solutions will be pushed
+		void close(int producer);
+		// Closes every producer and waits for the consumers to drain the rings
+		void join();
+
+		int64_t getSolutionCount() const { return mSolutionCount.load(); }
+		int64_t getUniqueCount() const { return mUniqueCount.load(); }
+
+	private:
+		static constexpr int cRingCapacity{ 128 };
+		static constexpr std::size_t cMaxHeld{ 4096 }; // Ordered only: solutions held by a producer not yet passed on
+		static constexpr int cMaxPlacements{ BitBoard<8>::cBits / 5 }; // Pieces on the largest bitboard
+		static constexpr int cKeyStripes{ 64 };
+
+		struct Placement
+		{
+			uint16_t cell{};       // Board index of the piece's top left corner
+			uint8_t orientation{};
+		};
+
+		struct Record
+		{
+			int count{};
+			Placement placements[cMaxPlacements];
+		};
+
+		struct Producer
+		{
+			SpscRing<Record, cRingCapacity> ring{};
+			std::atomic<bool> closed{};
+			// Ordered only, written by the producer's consumer and read by the merge.
+			// Every solution of a board has the same number of pieces, so held placements are one flat list.
+			std::mutex heldLock{};
+			std::vector<std::string> heldKeys{};
+			std::vector<Placement> heldPlacements{};
+			bool drained{}; // Closed, and every solution it pushed is held or dropped
+		};
+
+		// Keys seen so far, split by hash so consumers rarely wait on each other
+		struct alignas(64) KeyStripe
+		{
+			std::mutex lock{};
+			std::unordered_set<std::string> keys{};
+		};
+
+		std::string mBoard{};
+		int mWidth{};
+		SolutionCanonicalizer mCanonicalizer;
+		UniqueCallback mOnUnique{};
+		std::mutex mOutputLock{};
+		bool mOrdered{};
+		std::atomic<int> mNextProducer{}; // Ordered only: first producer not yet fully passed on, written under mOutputLock
+		int mProducerCount{};
+		std::unique_ptr<Producer[]> mProducers{};
+		std::unique_ptr<KeyStripe[]> mKeyStripes{};
+		std::vector<std::thread> mConsumers{};
+		std::atomic<int64_t> mSolutionCount{};
+		std::atomic<int64_t> mUniqueCount{};
+
+		void consume(int first, int step);
+		void decode(const Placement* placements, int count, std::vector<PlacedPentomino>& solution, std::string& cells) const;
+		bool insertKey(std::string&& key);
+		bool containsKey(const std::string& key);
+		bool isHeldFull(int producer);
+		void merge(bool wait);
+	};
+}
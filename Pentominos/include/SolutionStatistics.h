@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Pentomino.h"
+#include "PentominoBoard.h"
+#include "SolutionCanonicalizer.h"
+
+namespace Pentominoes
+{
+	struct PlacedPentomino;
+
+	// Running totals over the solutions of one board: how often each piece covers each cell, how often each
+	// orientation is placed, and how often each pair of pieces shares an edge. Memory doesn't depend on the
+	// number of solutions, since the solutions themselves aren't kept.
+	// Each search thread adds to a copy of its own, and the copies are merged when the search is done.
+	//
+	// With symmetry weighting, a solution counts as 1 / (number of distinct solutions it maps to under the
+	// board's symmetries), so the totals are those of the solutions left after removeTrivialSolutions().
+	// Solution, piece and adjacency totals match that set exactly. Cell and orientation totals depend on
+	// which solution of each symmetric set is kept, and give the average over the set instead.
+	// Without repeats, a board of more than 12 pieces may have only some of the symmetric solutions of a solution,
+	// since the search fills cells in row-major order and the pieces that repeat depend on that order. There a
+	// solution's set is only those of its transformations the search would find too.
+	class SolutionStatistics
+	{
+		friend class PentominoSolver;
+	public:
+		SolutionStatistics(const PentominoBoard& board, bool symmetryWeighted);
+
+		void add(const std::vector<PlacedPentomino>& solution);
+		// Precondition: other was made for the same board with the same weighting
+		void merge(const SolutionStatistics& other);
+		// Drops the totals, keeping the board and weighting
+		void clear();
+
+		double getSolutionCount() const { return getWeighted(mSolutions); }
+		// Solutions with the piece covering the cell
+		double getCellCount(OrientationBase piece, int x, int y) const
+		{
+			return getWeighted(mCells[(static_cast<std::size_t>(y) * mWidth + x) * Pentomino::cTotalBasePieces + static_cast<int>(piece)]);
+		}
+		// Placements of the orientation, summed over every solution
+		double getOrientationCount(const Pentomino& piece) const { return getWeighted(mOrientations[static_cast<int>(piece)]); }
+		double getPieceCount(OrientationBase piece) const;
+		// Pairs of pieces of these kinds sharing at least one edge, summed over every solution
+		double getAdjacencyCount(OrientationBase a, OrientationBase b) const;
+
+		// Share of solutions with the piece covering each cell, as a percentage
+		void printHeatmap(OrientationBase piece) const;
+		// Placements of each piece and orientation per solution, and adjacent pieces per solution
+		void printTables() const;
+
+	private:
+		static constexpr int cAdjacencyPairs{ Pentomino::cTotalBasePieces * (Pentomino::cTotalBasePieces + 1) / 2 };
+
+		std::string mBoard{};
+		int mWidth{};
+		int mHeight{};
+		// Weighted totals are kept as whole multiples of 1 / mWeightScale, a multiple of every possible size of a
+		// symmetric set: 1 to the number of symmetries including the identity
+		int mWeightScale{ 1 };
+		int mSymmetryCount{ 1 }; // Including the identity
+		std::shared_ptr<const SolutionCanonicalizer> mCanonicalizer{}; // Only with symmetry weighting
+		bool mRepeatsFollowOrder{}; // Set by PentominoSolver::findStatistics(), see BitBoardSolver::repeatsFollowOrder()
+
+		int64_t mSolutions{};
+		std::vector<int64_t> mCells{};  // Indexed by cell, then piece
+		int64_t mOrientations[Pentomino::cTotalOrientations]{};
+		int64_t mAdjacency[cAdjacencyPairs]{}; // Pairs a <= b, see getPairIndex()
+
+		// Reused by add()
+		std::string mCellsBuffer{};
+		std::vector<int> mPieceOfCell{};
+		std::vector<bool> mAdjacentPieces{};
+		std::string mTransformBuffer{};
+		std::vector<std::string> mSetBuffer{}; // Distinct symmetric solutions found so far
+		std::vector<bool> mPiecePlaced{};
+
+		double getWeighted(int64_t total) const { return static_cast<double>(total) / mWeightScale; }
+		int getSymmetricSetSize(const std::vector<PlacedPentomino>& solution);
+		bool isInSearchOrder(const std::vector<PlacedPentomino>& solution, const CellTransform& transform);
+		static int getPairIndex(int a, int b);
+	};
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "PentominoBoard.h"
+
+namespace Pentominoes
+{
+	struct PlacedPentomino;
+
+	// Receives solutions of an asynchronous solve a batch at a time, from one pool thread at a time.
+	// Must not throw.
+	using SolutionBatchCallback = std::function<void(const std::vector<std::vector<PlacedPentomino>>& batch)>;
+
+	// Everything PentominoSolver::solveAsync() needs to run a search
+	struct SolveRequest
+	{
+		PentominoBoard board{};
+		bool minimizeRepeats{ true };
+		SolutionBatchCallback onSolutions{}; // If empty, solutions are only counted
+		int batchSize{ 64 };                 // Solutions collected by a search thread before they're passed on
+		bool ordered{};                      // Pass solutions on in the order of a single-threaded search
+	};
+
+	enum class JobStatus
+	{
+		Running,
+		Finished,
+		Cancelled,  // cancel() was called and every task has stopped, the solutions passed on were all there will be
+		Unsupported // Board too large for the bitboard search, nothing was searched
+	};
+
+	struct SolveProgress
+	{
+		int64_t nodes{};     // Search states visited so far
+		int64_t solutions{}; // Solutions found so far, some may not have been passed on yet
+		double completion{}; // Fraction of first pieces searched, a rough estimate since branches differ in size
+	};
+
+	// Handle to a search running on the ThreadPool, returned by PentominoSolver::solveAsync().
+	// Each piece that fits the first open cell is searched as its own task, and the handle may be
+	// dropped without waiting, the tasks keep the job alive until they're done.
+	// For an ordered request, the tasks are numbered in the order a single thread would search them. Batches
+	// of the lowest unfinished task are passed on right away and those of later tasks are held until every
+	// earlier task has finished, so the solutions arrive in the same order on every run. A task holding
+	// cMaxHeld solutions stops searching until it's the lowest unfinished task. The pool runs tasks in the
+	// order they were submitted, so every earlier task is already running and none of them waits for it.
+	class SolveJob
+	{
+	public:
+		SolveJob(const SolveJob&) = delete;
+		SolveJob& operator=(const SolveJob&) = delete;
+
+		SolveProgress getProgress() const;
+		JobStatus getStatus() const;
+		bool isDone() const;
+		// Stops every task at its next state, tasks not started yet don't search at all. No batch is passed on
+		// after this returns except one already in the callback, and getStatus() stays Running until every task
+		// has stopped.
+		void cancel();
+		void wait();
+		// Returns true if the job finished within the timeout
+		template <class Rep, class Period>
+		bool waitFor(const std::chrono::duration<Rep, Period>& timeout)
+		{
+			std::unique_lock<std::mutex> guard{ mDoneLock };
+			return mDoneSignal.wait_for(guard, timeout, [this]() { return mDone; });
+		}
+
+		static constexpr std::size_t cMaxHeld{ 4096 }; // Ordered only: solutions held by a task not yet passed on
+
+	private:
+		friend class PentominoSolver;
+		friend class SelfCheck;
+
+		SolutionBatchCallback mOnSolutions{};
+		int mBatchSize{};
+		bool mOrdered{};
+		int mTasks{};
+		bool mUnsupported{};
+		std::atomic<int> mTasksLeft{};
+		std::atomic<int64_t> mNodes{};
+		std::atomic<int64_t> mSolutions{};
+		std::atomic<bool> mCancelled{};
+		std::mutex mCallbackLock{};
+		int mNextTask{};                 // Ordered only: task whose batches are passed on as they come
+		std::vector<bool> mTaskFinished{};
+		std::vector<std::vector<std::vector<PlacedPentomino>>> mHeld{}; // Solutions of each later task, in order
+		std::condition_variable mHeldSignal{}; // mNextTask moved on or the job was cancelled
+		mutable std::mutex mDoneLock{};
+		std::condition_variable mDoneSignal{};
+		bool mDone{};
+
+		SolveJob(SolutionBatchCallback onSolutions, int batchSize, bool ordered);
+		// Called once before any task is submitted, finishes the job right away if there are none
+		void start(int tasks, bool unsupported = false);
+		// Precondition: 0 <= task < the number of tasks passed to start()
+		void deliver(int task, const std::vector<std::vector<PlacedPentomino>>& batch);
+		void finishTask(int task);
+		void releaseHeld(int task);
+		void finish();
+	};
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "PentominoBoard.h"
+
+namespace Pentominoes
+{
+	// Long running solver that answers requests from other processes on the same machine, over a Unix
+	// domain socket, or a named pipe on Windows. Each connection carries one request:
+	//
+	//   solve [-D] [-T] [count] [first=N] [timeout=SECONDS] [client=NAME]
+	//   <board, in the same format as promptUserInputBoard()>
+	//   <blank line>
+	//
+	// -D allows repeated pieces and -T keeps trivial solutions, as in the interactive prompt. count only
+	// returns the number of solutions, counted by the count strategies where they apply, first=N stops after
+	// N solutions, and timeout stops the search after that many seconds. The reply is one line
+	//
+	//   status <finished|first|timeout|unsupported> solutions <n> seconds <time> cached <0|1>
+	//
+	// followed by each solved board and a blank line, or a single "error <message>" line.
+	//
+	// Requests wait in one queue per client and the clients take turns, so a client with many requests
+	// doesn't hold up the others. One request runs at a time, spread over the whole ThreadPool.
+	// Complete results are kept for the board in its canonical orientation, so a request for any rotation
+	// or reflection of a board solved earlier is answered without searching.
+	// Queue depth, cache use and the timing of recent jobs are rewritten to a text file after every change.
+	class SolverDaemon
+	{
+	public:
+		// Unix socket path or pipe name used when none is given
+		static const char* getDefaultEndpoint();
+
+		SolverDaemon(std::string endpoint, std::string metricsPath);
+		SolverDaemon(const SolverDaemon&) = delete;
+		SolverDaemon& operator=(const SolverDaemon&) = delete;
+		~SolverDaemon();
+
+		// Serves requests until stop() is called. Returns false if the endpoint can't be opened.
+		bool run();
+		// May be called from any thread, including while run() is starting
+		void stop();
+
+	private:
+		static constexpr int cMaxQueued{ 256 };                  // Requests waiting across all clients before new ones are turned away
+		static constexpr int cMaxCacheEntries{ 256 };
+		static constexpr int64_t cMaxCachedSolutions{ 1 << 16 }; // Larger results are cached as a count only
+		static constexpr int cRecentJobs{ 16 };                  // Jobs listed in the metrics file
+
+		struct Request
+		{
+			std::string client{};
+			PentominoBoard board{};
+			bool minimizeRepeats{ true };
+			bool keepTrivial{};
+			bool countOnly{};
+			int64_t first{};  // 0 for every solution
+			double timeout{}; // Seconds, 0 for no limit
+			std::chrono::steady_clock::time_point queued{};
+			std::promise<std::string> reply{};
+		};
+
+		// Result of a search that ran to the end, for the board in its canonical orientation
+		struct CacheEntry
+		{
+			int64_t count{};
+			bool hasSolutions{};
+			std::vector<std::string> solutions{};
+		};
+
+		struct JobRecord
+		{
+			int64_t id{};
+			std::string client{};
+			int width{};
+			int height{};
+			std::string status{};
+			int64_t solutions{};
+			double queuedSeconds{};
+			double runSeconds{};
+			bool cached{};
+		};
+
+		// A socket descriptor, or a pipe handle on Windows
+		struct Connection
+		{
+			std::intptr_t channel{};
+			std::thread thread{};
+			std::atomic<bool> done{};
+		};
+
+		std::string mEndpoint{};
+		std::string mMetricsPath{};
+		std::atomic<bool> mStopping{};
+		std::atomic<std::intptr_t> mListener{ -1 }; // Listening socket, unused with named pipes
+
+		// Queued requests of each client, and the order clients take turns in
+		std::mutex mQueueLock{};
+		std::condition_variable mQueueSignal{};
+		std::map<std::string, std::deque<std::unique_ptr<Request>>> mQueues{};
+		std::deque<std::string> mTurns{};
+		int mQueued{};
+
+		// Most recently used first
+		std::mutex mCacheLock{};
+		std::list<std::string> mCacheOrder{};
+		std::unordered_map<std::string, std::pair<std::shared_ptr<const CacheEntry>, std::list<std::string>::iterator>> mCache{};
+
+		std::mutex mMetricsLock{};
+		int64_t mNextJobId{ 1 };
+		int64_t mJobsCompleted{};
+		int64_t mCacheHits{};
+		int64_t mCacheMisses{};
+		double mTotalRunSeconds{};
+		bool mRunning{};
+		std::deque<JobRecord> mRecentJobs{};
+
+		std::mutex mConnectionLock{};
+		std::list<Connection> mConnections{};
+
+		void serveConnection(std::intptr_t channel);
+		bool enqueue(std::unique_ptr<Request> request);
+		void schedule();
+		std::string solve(const Request& request, JobRecord& record);
+		static bool countCanonical(const Request& request, const PentominoBoard& canonical, int64_t& count);
+		std::shared_ptr<const CacheEntry> findCached(const std::string& key, bool needSolutions);
+		void storeCached(const std::string& key, std::shared_ptr<const CacheEntry> entry);
+		void writeMetrics();
+	};
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace Pentominoes
+{
+	// Bounded lock-free queue between exactly one producer thread and one consumer thread.
+	// Slots are written and read in place, so large records aren't copied through the queue.
+	// Capacity must be a power of 2.
+	template <class T, int Capacity>
+	class SpscRing
+	{
+	public:
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+		// Producer only: slot to fill, or nullptr if the ring is full. Call publish() once it's filled.
+		T* tryAcquire()
+		{
+			uint32_t tail{ mTail.load(std::memory_order_relaxed) };
+			if (tail - mHeadCache == Capacity)
+			{
+				mHeadCache = mHead.load(std::memory_order_acquire);
+				if (tail - mHeadCache == Capacity)
+					return nullptr;
+			}
+			return &mSlots[tail & (Capacity - 1)];
+		}
+		void publish() { mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+		// Consumer only: oldest published slot, or nullptr if the ring is empty. Call pop() when done with it.
+		const T* front()
+		{
+			uint32_t head{ mHead.load(std::memory_order_relaxed) };
+			if (head == mTailCache)
+			{
+				mTailCache = mTail.load(std::memory_order_acquire);
+				if (head == mTailCache)
+					return nullptr;
+			}
+			return &mSlots[head & (Capacity - 1)];
+		}
+		void pop() { mHead.store(mHead.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+	private:
+		static constexpr int cCacheLine{ 64 };
+
+		// Each index on its own cache line, next to the other side's cached copy of it
+		alignas(cCacheLine) std::atomic<uint32_t> mHead{};
+		uint32_t mTailCache{}; // Consumer's last read of mTail
+		alignas(cCacheLine) std::atomic<uint32_t> mTail{};
+		uint32_t mHeadCache{}; // Producer's last read of mHead
+		alignas(cCacheLine) T mSlots[Capacity];
+	};
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Pentomino.h"
+#include "PentominoBoard.h"
+
+namespace Pentominoes
+{
+	// A piece orientation anchored at its first cell in column-major order
+	struct SweepPlacement
+	{
+		uint64_t mask{};  // Cells covered, relative to the anchor in sweep order
+		int offsets[5]{}; // Same cells as sweep order offsets
+		int minRow{};     // Row offsets of the highest and lowest cells relative to the anchor
+		int maxRow{};
+		int columns{};    // Number of columns spanned
+		int base{};       // OrientationBase of the piece, as an int
+	};
+
+	// Column-major view of a board used by the counting strategies.
+	// The board is laid out along its longest dimension, so each column holds the
+	// cells of the shorter dimension and cell indices run down each column in turn.
+	// Transposing the board doesn't change any counts since the set of orientations
+	// is closed under transposition.
+	class SweepLayout
+	{
+	public:
+		// Pieces reach at most 4 columns past their anchor, so 5 columns of cells
+		// must fit in a 64 bit mask.
+		static constexpr int cMaxSpan{ 12 };
+
+		SweepLayout(const PentominoBoard& board);
+
+		int getLength() const { return mLength; }
+		int getSpan() const { return mSpan; }
+		int getTotalCells() const { return mLength * mSpan; }
+		int getOpenCells() const { return mOpenCells; }
+		bool isWall(int cell) const { return mWalls[cell]; }
+		const std::vector<SweepPlacement>& getPlacements() const { return mPlacements; }
+
+		// Returns true if the placement stays on the board when anchored at the cell
+		bool isInBounds(const SweepPlacement& placement, int cell) const
+		{
+			int col{ cell / mSpan };
+			int row{ cell % mSpan };
+			return row + placement.minRow >= 0
+				&& row + placement.maxRow < mSpan
+				&& col + placement.columns <= mLength;
+		}
+
+	private:
+		std::vector<bool> mWalls{};
+		std::vector<SweepPlacement> mPlacements{};
+		int mLength{}; // Number of columns
+		int mSpan{};   // Number of cells in each column
+		int mOpenCells{};
+
+		void buildPlacements();
+	};
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Pentominoes
+{
+	// Worker threads that live for the whole program, so asynchronous solves don't start and join
+	// threads of their own. Tasks run in the order they were submitted.
+	class ThreadPool
+	{
+	public:
+		using Task = std::function<void()>;
+
+		// One worker per hardware thread, started on first use
+		static ThreadPool& get();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		~ThreadPool();
+
+		void submit(Task task);
+		int getThreadCount() const { return static_cast<int>(mWorkers.size()); }
+
+	private:
+		std::mutex mLock{};
+		std::condition_variable mWake{};
+		std::deque<Task> mTasks{};
+		std::vector<std::thread> mWorkers{};
+		bool mShutdown{};
+
+		explicit ThreadPool(int threads);
+		void work();
+	};
+}
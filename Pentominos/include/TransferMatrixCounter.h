@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "PentominoBoard.h"
+#include "SweepLayout.h"
+#include "WideCount.h"
+
+namespace Pentominoes
+{
+	// Counts solutions in repeats mode without enumerating them, using a dynamic program
+	// over frontier profiles (a transfer matrix / broken profile sweep).
+	// The board is swept one column at a time along its longest dimension, cell by cell
+	// down each column. The state is a bitmask of which of the upcoming cells are already
+	// covered by previously placed pieces, mapped to the number of partial tilings that reach it.
+	class TransferMatrixCounter
+	{
+	public:
+		static constexpr int cMaxFrontierWidth{ SweepLayout::cMaxSpan };
+
+		TransferMatrixCounter(const PentominoBoard& board);
+
+		// Returns true if the short dimension of the board is narrow enough to sweep
+		bool canCount() const { return mLayout.getSpan() <= cMaxFrontierWidth; }
+		// Precondition: canCount() == true
+		WideCount count() const;
+		int getLargestProfileCount() const { return mLargestProfileCount; }
+
+	private:
+		SweepLayout mLayout;
+		std::vector<uint64_t> mWallWindows{}; // Wall cells in the profile window starting at each cell
+		mutable int mLargestProfileCount{};
+	};
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "BitBoard.h"
+#include "WideCount.h"
+
+namespace Pentominoes
+{
+	// How well a TranspositionTable did during a count
+	struct TranspositionStats
+	{
+		int64_t lookups{};
+		int64_t hits{};
+		int64_t stores{};
+		int64_t evictions{}; // Stores that replaced the count of a different state
+
+		double getHitRate() const { return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0; }
+		void print() const;
+	};
+
+	// Number of ways to finish a search state, shared by every counting thread.
+	// A state is the set of open cells plus the pieces already used in the current round, which is
+	// everything the rest of the search depends on, so different placement orders that reach the same
+	// state only count it once.
+	// The table never grows past the size it's given. Entries live in buckets of 4, and storing into a
+	// full bucket evicts the entry with the fewest open cells, the cheapest subtree to count again.
+	// Each bucket is guarded by one of a fixed number of striped locks.
+	template <int Words>
+	class TranspositionTable
+	{
+	public:
+		using Board = BitBoard<Words>;
+
+		// Precondition: bytes is large enough for at least one bucket
+		explicit TranspositionTable(std::size_t bytes);
+
+		// Returns true and sets count if the state is in the table
+		bool find(const Board& open, uint32_t usedPieces, WideCount& count);
+		// Precondition: openCells == open.popCount() > 0
+		void store(const Board& open, uint32_t usedPieces, int openCells, const WideCount& count);
+		TranspositionStats getStats() const;
+
+	private:
+		static constexpr int cWays{ 4 };
+		static constexpr int cStripes{ 256 };
+
+		struct Entry
+		{
+			Board open{};
+			WideCount count{};
+			uint32_t usedPieces{};
+			int32_t openCells{}; // 0 if the entry is empty
+		};
+
+		// Counters are updated under the stripe's lock, so threads don't share a counter
+		struct alignas(64) Stripe
+		{
+			std::mutex lock{};
+			TranspositionStats stats{};
+		};
+
+		std::vector<Entry> mEntries{};
+		std::size_t mBucketMask{};
+		std::unique_ptr<Stripe[]> mStripes{};
+
+		std::size_t getBucket(const Board& open, uint32_t usedPieces) const;
+	};
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace Pentominoes
+{
+	// Unsigned 128 bit counter for solution counts that overflow 64 bits.
+	// Only supports the operations the counting strategies need, and is written
+	// without compiler specific 128 bit types so it builds under MSVC.
+	struct WideCount
+	{
+		uint64_t low{ 0 };
+		uint64_t high{ 0 };
+
+		WideCount() {}
+		WideCount(uint64_t value) : low{ value } {}
+
+		WideCount& operator+=(const WideCount& other)
+		{
+			uint64_t sum = low + other.low;
+			high += other.high + (sum < low ? 1 : 0); // carry
+			low = sum;
+			return *this;
+		}
+
+		friend WideCount operator+(WideCount a, const WideCount& b)
+		{
+			a += b;
+			return a;
+		}
+
+		// Precondition: other <= *this
+		WideCount& operator-=(const WideCount& other)
+		{
+			high -= other.high + (low < other.low ? 1 : 0); // borrow
+			low -= other.low;
+			return *this;
+		}
+
+		// Multiply by another count, discarding anything past 128 bits
+		friend WideCount operator*(const WideCount& a, const WideCount& b)
+		{
+			// Schoolbook multiply of the low words in 32 bit halves
+			uint64_t a0 = a.low & 0xFFFFFFFF, a1 = a.low >> 32;
+			uint64_t b0 = b.low & 0xFFFFFFFF, b1 = b.low >> 32;
+			uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+			uint64_t middle = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+
+			WideCount result{};
+			result.low = (middle << 32) | (p00 & 0xFFFFFFFF);
+			result.high = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32)
+				+ a.low * b.high + a.high * b.low;
+			return result;
+		}
+
+		bool operator==(const WideCount& other) const { return low == other.low && high == other.high; }
+		bool operator!=(const WideCount& other) const { return !(*this == other); }
+		bool operator<(const WideCount& other) const { return high < other.high || (high == other.high && low < other.low); }
+		bool isZero() const { return low == 0 && high == 0; }
+
+		// Decimal representation, computed by repeated long division by 10
+		std::string toString() const
+		{
+			if (isZero())
+				return "0";
+
+			std::string digits{};
+			WideCount value{ *this };
+			while (!value.isZero())
+			{
+				// Divide the 128 bit value by 10 one 32 bit limb at a time
+				uint32_t limbs[4]{ static_cast<uint32_t>(value.high >> 32), static_cast<uint32_t>(value.high),
+					static_cast<uint32_t>(value.low >> 32), static_cast<uint32_t>(value.low) };
+				uint64_t remainder{ 0 };
+				for (int i = 0; i < 4; i++)
+				{
+					uint64_t current = (remainder << 32) | limbs[i];
+					limbs[i] = static_cast<uint32_t>(current / 10);
+					remainder = current % 10;
+				}
+				value.high = (static_cast<uint64_t>(limbs[0]) << 32) | limbs[1];
+				value.low = (static_cast<uint64_t>(limbs[2]) << 32) | limbs[3];
+				digits.insert(digits.begin(), static_cast<char>('0' + remainder));
+			}
+			return digits;
+		}
+	};
+}
@@ -0,0 +1,191 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#include "AllocationTracker.h"
+
+namespace Pentominoes
+{
+#if TRACK_ALLOCATIONS
+	namespace
+	{
+		std::atomic<int64_t> allocationCounts[static_cast<int>(AllocationPhase::Total)]{};
+		thread_local AllocationPhase currentPhase{ AllocationPhase::Other };
+	}
+
+	AllocationScope::AllocationScope(AllocationPhase phase)
+		: mPrevious{ currentPhase }
+	{
+		currentPhase = phase;
+	}
+
+	AllocationScope::~AllocationScope()
+	{
+		currentPhase = mPrevious;
+	}
+
+	int64_t AllocationTracker::getCount(AllocationPhase phase)
+	{
+		return allocationCounts[static_cast<int>(phase)].load();
+	}
+
+	void AllocationTracker::reset()
+	{
+		for (std::atomic<int64_t>& count : allocationCounts)
+			count = 0;
+	}
+
+	namespace
+	{
+		void* allocate(std::size_t size, std::size_t alignment = 0)
+		{
+			allocationCounts[static_cast<int>(currentPhase)].fetch_add(1, std::memory_order_relaxed);
+			if (size == 0)
+				size = 1;
+			void* block{ nullptr };
+			if (alignment == 0)
+				block = std::malloc(size);
+			else
+#if defined(_WIN32)
+				block = _aligned_malloc(size, alignment);
+#else
+				block = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+			return block;
+		}
+
+		void deallocateAligned(void* block)
+		{
+#if defined(_WIN32)
+			_aligned_free(block);
+#else
+			std::free(block);
+#endif
+		}
+	}
+#else
+	int64_t AllocationTracker::getCount(AllocationPhase)
+	{
+		return 0;
+	}
+
+	void AllocationTracker::reset()
+	{
+	}
+#endif
+
+	void AllocationTracker::print()
+	{
+		if (!cEnabled)
+		{
+			std::cout << "Allocation tracking is off, build with TRACK_ALLOCATIONS=1\n";
+			return;
+		}
+		std::cout << "Heap allocations by phase:\n";
+		for (int i = 0; i < static_cast<int>(AllocationPhase::Total); i++)
+		{
+			AllocationPhase phase{ static_cast<AllocationPhase>(i) };
+			std::cout << "  " << getPhaseName(phase) << ": " << getCount(phase) << "\n";
+		}
+	}
+
+	const char* AllocationTracker::getPhaseName(AllocationPhase phase)
+	{
+		switch (phase)
+		{
+		case AllocationPhase::Other:
+			return "Other";
+		case AllocationPhase::Search:
+			return "Search";
+		case AllocationPhase::SolutionStorage:
+			return "Solution storage";
+		case AllocationPhase::SolutionHandling:
+			return "Solution handling";
+		default:
+			return "Unknown";
+		}
+	}
+}
+
+#if TRACK_ALLOCATIONS
+void* operator new(std::size_t size)
+{
+	void* block{ Pentominoes::allocate(size) };
+	if (!block)
+		throw std::bad_alloc{};
+	return block;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Pentominoes::allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return Pentominoes::allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	void* block{ Pentominoes::allocate(size, static_cast<std::size_t>(alignment)) };
+	if (!block)
+		throw std::bad_alloc{};
+	return block;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void operator delete(void* block) noexcept
+{
+	std::free(block);
+}
+
+void operator delete[](void* block) noexcept
+{
+	std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept
+{
+	std::free(block);
+}
+
+void operator delete[](void* block, std::size_t) noexcept
+{
+	std::free(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept
+{
+	Pentominoes::deallocateAligned(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept
+{
+	Pentominoes::deallocateAligned(block);
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept
+{
+	Pentominoes::deallocateAligned(block);
+}
+
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept
+{
+	Pentominoes::deallocateAligned(block);
+}
+#endif
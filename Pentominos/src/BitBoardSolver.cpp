@@ -0,0 +1,594 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+
+#include "AllocationTracker.h"
+#include "BitBoardSolver.h"
+#include "PentominoSolver.h"
+#include "Debug.h"
+
+namespace Pentominoes
+{
+	namespace
+	{
+		// Uniform in [0, bound), by drawing only as many bits as bound has and retrying the draws past it
+		// Precondition: bound > 0
+		WideCount drawBelow(const WideCount& bound, std::mt19937_64& random)
+		{
+			if (bound.high == 0)
+				return std::uniform_int_distribution<uint64_t>{ 0, bound.low - 1 }(random);
+			uint64_t mask{ bound.high };
+			for (int shift = 1; shift < 64; shift *= 2)
+				mask |= mask >> shift;
+			while (true)
+			{
+				WideCount value{};
+				value.high = random() & mask;
+				value.low = random();
+				if (value < bound)
+					return value;
+			}
+		}
+
+		// Orientation with the cells of the given one reflected across the main diagonal
+		PieceOrientation getTransposed(PieceOrientation orientation)
+		{
+			static const std::array<PieceOrientation, Pentomino::cTotalOrientations> cTransposed{ []()
+			{
+				// Cells of each orientation as a 5x5 mask, and the same mask transposed
+				uint32_t shapes[Pentomino::cTotalOrientations]{};
+				uint32_t transposed[Pentomino::cTotalOrientations]{};
+				for (int i = 0; i < Pentomino::cTotalOrientations; i++)
+				{
+					for (const PieceCell& cell : Pentomino(static_cast<PieceOrientation>(i)).getCells())
+					{
+						shapes[i] |= 1u << (cell.y * 5 + cell.x);
+						transposed[i] |= 1u << (cell.x * 5 + cell.y);
+					}
+				}
+				std::array<PieceOrientation, Pentomino::cTotalOrientations> table{};
+				for (int i = 0; i < Pentomino::cTotalOrientations; i++)
+					table[i] = static_cast<PieceOrientation>(std::find(shapes, shapes + Pentomino::cTotalOrientations, transposed[i]) - shapes);
+				return table;
+			}() };
+			return cTransposed[static_cast<int>(orientation)];
+		}
+	}
+
+	template <int Words, int Width, int Height>
+	BitBoardSolver<Words, Width, Height>::BitBoardSolver(const PentominoBoard& board, bool minimizeRepeats, PlacementKernel kernel)
+		: mFitTest{ getFitTest(kernel) },
+		mNeighborhoodTable{ kernel == PlacementKernel::Neighborhood ? &NeighborhoodTable::get() : nullptr },
+		mTransposed{ isTransposed(board, minimizeRepeats) }, mMinimizeRepeats{ minimizeRepeats },
+		mRepeatsFollowOrder{ repeatsFollowOrder(board, minimizeRepeats) }
+	{
+		mWidth = mTransposed ? board.mHeight : board.mWidth;
+		mHeight = mTransposed ? board.mWidth : board.mHeight;
+		for (int row = 0; row < getHeight(); row++)
+		{
+			for (int col = 0; col < getWidth(); col++)
+			{
+				if (board[mTransposed ? col * board.mWidth + row : row * getWidth() + col] == '0')
+					mFree.set(row * getStride() + col);
+				if ((row + col) % 2 == 0)
+					mBlackCells.set(row * getStride() + col);
+			}
+		}
+		buildCandidates();
+		mSolutions = SolutionArena<const Candidate*>{ mFree.popCount() / 5 };
+	}
+
+	// For each open cell, list every orientation that fits on the board with its first cell there
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::buildCandidates()
+	{
+		std::shared_ptr<CandidateTable> table{ std::make_shared<CandidateTable>() };
+		int stride{ getStride() };
+		for (int cell = 0; cell < stride * getHeight(); cell++)
+		{
+			table->firstCandidate.push_back(static_cast<int>(table->candidates.size()));
+			table->firstMask.push_back(static_cast<int>(table->masks.size()));
+			table->validOrientations.push_back(0);
+			if (!mFree.test(cell))
+				continue;
+
+			for (int i = 0; i < Pentomino::cTotalOrientations; i++)
+			{
+				Pentomino piece{ static_cast<PieceOrientation>(i) };
+				int x{ cell % stride - piece.getXOffset() };
+				int y{ cell / stride };
+				if (x < 0 || x + piece.getRectangleWidth() > getWidth() || y + piece.getRectangleHeight() > getHeight())
+					continue;
+
+				Candidate candidate{};
+				for (const PieceCell& pieceCell : piece.getCells())
+					candidate.mask.set((y + pieceCell.y) * stride + x + pieceCell.x);
+				if (!candidate.mask.isSubsetOf(mFree))
+					continue;
+
+				candidate.orientation = piece.getOrientation();
+				candidate.base = static_cast<int8_t>(piece.getBasePiece());
+				candidate.boardOrientation = mTransposed ? getTransposed(piece.getOrientation()) : piece.getOrientation();
+				candidate.x = static_cast<int8_t>(mTransposed ? y : x);
+				candidate.y = static_cast<int8_t>(mTransposed ? x : y);
+				table->candidates.push_back(candidate);
+				table->validOrientations.back() |= uint64_t{ 1 } << i;
+			}
+
+			// Word by word copy of this cell's masks, padded with masks that never fit
+			int first{ table->firstCandidate.back() };
+			int count{ static_cast<int>(table->candidates.size()) - first };
+			int maskStride{ (count + cPlacementKernelLanes - 1) / cPlacementKernelLanes * cPlacementKernelLanes };
+			for (int w = 0; w < Words; w++)
+			{
+				for (int i = 0; i < maskStride; i++)
+					table->masks.push_back(i < count ? table->candidates[first + i].mask.words[w] : ~uint64_t{ 0 });
+			}
+		}
+		table->firstCandidate.push_back(static_cast<int>(table->candidates.size()));
+		table->firstMask.push_back(static_cast<int>(table->masks.size()));
+		mCandidates = table;
+	}
+
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::searchFrom(const Pentomino& firstPiece)
+	{
+		int firstCell{ mFree.findFirst() };
+		if (firstCell < 0)
+			return;
+
+		// Room for every piece of a solution up front, so placing pieces never allocates
+		int pieces{ static_cast<int>(mPlaced.size()) + mFree.popCount() / 5 };
+		mPlaced.reserve(pieces);
+		mSolutionBuffer.reserve(pieces);
+		AllocationScope scope{ AllocationPhase::Search };
+
+		const Candidate* candidates{ mCandidates->candidates.data() + mCandidates->firstCandidate[firstCell] };
+		uint64_t fitting{ findFitting(firstCell) };
+		while (fitting && !isStopped())
+		{
+			const Candidate& candidate{ candidates[countTrailingZeros64(fitting)] };
+			fitting &= fitting - 1;
+			if (candidate.orientation == firstPiece.getOrientation() && tryPlace(candidate))
+			{
+				search();
+				removeLast();
+			}
+		}
+		if (mNodeCounter)
+			reportNodes();
+	}
+
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::searchAll()
+	{
+		for (int i = 0; i < Pentomino::cTotalOrientations && !isStopped(); i++)
+			searchFrom(Pentomino(static_cast<PieceOrientation>(i)));
+	}
+
+	// Recursive backtracking function, called after each successful placement
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::search()
+	{
+		if (mNodeCounter && ++mUnreportedNodes == cNodeReportInterval)
+			reportNodes();
+		if (mFree.isEmpty())
+		{
+			recordSolution();
+			return;
+		}
+		if (!isPossibleSolution())
+			return;
+
+		// Next branches consist of all available fitting pieces in the next open cell
+		int nextCell{ mFree.findFirst() };
+		const Candidate* candidates{ mCandidates->candidates.data() + mCandidates->firstCandidate[nextCell] };
+		uint64_t fitting{ findFitting(nextCell) };
+		while (fitting && !isStopped())
+		{
+			const Candidate& candidate{ candidates[countTrailingZeros64(fitting)] };
+			fitting &= fitting - 1;
+			if (tryPlace(candidate))
+			{
+				search();
+				removeLast();
+			}
+		}
+	}
+
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::searchFrom(const Pentomino& firstPiece, TranspositionTable<Words>& table)
+	{
+		int firstCell{ mFree.findFirst() };
+		if (firstCell < 0)
+			return;
+
+		int pieces{ static_cast<int>(mPlaced.size()) + mFree.popCount() / 5 };
+		mPlaced.reserve(pieces);
+		mSolutionBuffer.reserve(pieces);
+
+		const Candidate* candidates{ mCandidates->candidates.data() + mCandidates->firstCandidate[firstCell] };
+		uint64_t fitting{ findFitting(firstCell) };
+		while (fitting && !isStopped())
+		{
+			const Candidate& candidate{ candidates[countTrailingZeros64(fitting)] };
+			fitting &= fitting - 1;
+			if (candidate.orientation == firstPiece.getOrientation() && tryPlace(candidate))
+			{
+				if (!count(table).isZero())
+					search(table);
+				removeLast();
+			}
+		}
+		if (mNodeCounter)
+			reportNodes();
+	}
+
+	// Same branches as search(), but only those the table counts any solutions below
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::search(TranspositionTable<Words>& table)
+	{
+		if (mNodeCounter && ++mUnreportedNodes == cNodeReportInterval)
+			reportNodes();
+		if (mFree.isEmpty())
+		{
+			recordSolution();
+			return;
+		}
+
+		int nextCell{ mFree.findFirst() };
+		const Candidate* candidates{ mCandidates->candidates.data() + mCandidates->firstCandidate[nextCell] };
+		uint64_t fitting{ findFitting(nextCell) };
+		while (fitting && !isStopped())
+		{
+			const Candidate& candidate{ candidates[countTrailingZeros64(fitting)] };
+			fitting &= fitting - 1;
+			if (tryPlace(candidate))
+			{
+				if (!count(table).isZero())
+					search(table);
+				removeLast();
+			}
+		}
+	}
+
+	template <int Words, int Width, int Height>
+	WideCount BitBoardSolver<Words, Width, Height>::countFrom(const Pentomino& firstPiece, TranspositionTable<Words>& table)
+	{
+		int firstCell{ mFree.findFirst() };
+		if (firstCell < 0)
+			return 0;
+
+		mPlaced.reserve(mFree.popCount() / 5);
+		WideCount total{};
+		const Candidate* candidates{ mCandidates->candidates.data() + mCandidates->firstCandidate[firstCell] };
+		uint64_t fitting{ findFitting(firstCell) };
+		while (fitting)
+		{
+			const Candidate& candidate{ candidates[countTrailingZeros64(fitting)] };
+			fitting &= fitting - 1;
+			if (candidate.orientation == firstPiece.getOrientation() && tryPlace(candidate))
+			{
+				total += count(table);
+				removeLast();
+			}
+		}
+		return total;
+	}
+
+	// Same branches as search(), called after each successful placement, but returns the number of
+	// solutions below this state and looks states with enough open cells up in the table first
+	template <int Words, int Width, int Height>
+	WideCount BitBoardSolver<Words, Width, Height>::count(TranspositionTable<Words>& table)
+	{
+		if (mFree.isEmpty())
+			return 1;
+		Board smallestIsland{};
+		if (!isPossibleSolution(smallestIsland))
+			return 0;
+
+		int openCells{ mFree.popCount() };
+		bool memoize{ openCells >= cMinMemoCells };
+		uint32_t usedPieces{ mMinimizeRepeats ? getUsedPieces() : 0 };
+		WideCount total{};
+		if (memoize && table.find(mFree, usedPieces, total))
+			return total;
+
+		// Islands that don't compete for pieces are counted on their own. Without repeats they do, so the
+		// smallest island is filled first instead, which finds dead ends early and lets the table count the
+		// rest once for each set of pieces the small island can use up. That's only the same count while the
+		// order pieces are placed in doesn't decide which of them may repeat.
+		if (smallestIsland != mFree && !mMinimizeRepeats)
+		{
+			total = countIslands(table);
+			if (memoize)
+				table.store(mFree, usedPieces, openCells, total);
+			return total;
+		}
+
+		int nextCell{ mRepeatsFollowOrder ? mFree.findFirst() : smallestIsland.findFirst() };
+		const Candidate* candidates{ mCandidates->candidates.data() + mCandidates->firstCandidate[nextCell] };
+		uint64_t fitting{ findFitting(nextCell) };
+		while (fitting)
+		{
+			const Candidate& candidate{ candidates[countTrailingZeros64(fitting)] };
+			fitting &= fitting - 1;
+			if (tryPlace(candidate))
+			{
+				total += count(table);
+				removeLast();
+			}
+		}
+
+		if (memoize)
+			table.store(mFree, usedPieces, openCells, total);
+		return total;
+	}
+
+	// Product of the counts of each island, with mFree set to one island at a time
+	template <int Words, int Width, int Height>
+	WideCount BitBoardSolver<Words, Width, Height>::countIslands(TranspositionTable<Words>& table)
+	{
+		Board open{ mFree };
+		Board remaining{ open };
+		WideCount product{ 1 };
+		while (!remaining.isEmpty() && !product.isZero())
+		{
+			mFree = findIsland(remaining.lowestBit(), remaining);
+			remaining -= mFree;
+			product = product * count(table);
+		}
+		mFree = open;
+		return product;
+	}
+
+	template <int Words, int Width, int Height>
+	bool BitBoardSolver<Words, Width, Height>::sample(TranspositionTable<Words>& table, std::mt19937_64& random, Solution& solution)
+	{
+		std::size_t start{ mPlaced.size() };
+		mPlaced.reserve(start + mFree.popCount() / 5);
+		const Candidate* branches[64]{};
+		WideCount counts[64]{};
+		bool found{ true };
+		while (!mFree.isEmpty())
+		{
+			// Solutions below each branch of the first open cell
+			int cell{ mFree.findFirst() };
+			const Candidate* candidates{ mCandidates->candidates.data() + mCandidates->firstCandidate[cell] };
+			uint64_t fitting{ findFitting(cell) };
+			int branchCount{ 0 };
+			WideCount total{};
+			while (fitting)
+			{
+				const Candidate& candidate{ candidates[countTrailingZeros64(fitting)] };
+				fitting &= fitting - 1;
+				if (tryPlace(candidate))
+				{
+					WideCount below{ count(table) };
+					removeLast();
+					if (below.isZero())
+						continue;
+					branches[branchCount] = &candidate;
+					counts[branchCount++] = below;
+					total += below;
+				}
+			}
+			if (total.isZero())
+			{
+				found = false;
+				break;
+			}
+
+			WideCount pick{ drawBelow(total, random) };
+			int branch{ 0 };
+			while (!(pick < counts[branch]))
+				pick -= counts[branch++];
+			tryPlace(*branches[branch]);
+		}
+
+		if (found)
+			decodeSolution(mPlaced.data(), solution);
+		while (mPlaced.size() > start)
+			removeLast();
+		return found;
+	}
+
+	// Bit i is set if piece i has already been placed in the current round, and so isn't available.
+	// Together with the open cells, this decides every branch below the current state.
+	template <int Words, int Width, int Height>
+	uint32_t BitBoardSolver<Words, Width, Height>::getUsedPieces() const
+	{
+		int round{ static_cast<int>(mPlaced.size()) / Pentomino::cTotalBasePieces };
+		uint32_t used{ 0 };
+		for (int i = 0; i < Pentomino::cTotalBasePieces; i++)
+		{
+			if (mPieceCounts[i] > round)
+				used |= uint32_t{ 1 } << i;
+		}
+		return used;
+	}
+
+	// Bit i is set if the i-th candidate of the cell fits on the open cells
+	template <int Words, int Width, int Height>
+	uint64_t BitBoardSolver<Words, Width, Height>::findFitting(int cell) const
+	{
+		const CandidateTable& table{ *mCandidates };
+		if (mNeighborhoodTable)
+		{
+			uint64_t valid{ table.validOrientations[cell] };
+			uint64_t orientations{ valid & mNeighborhoodTable->findFitting(mFree, cell, getStride()) };
+			// Candidates are in orientation order, so a candidate's index is the number of valid orientations before it
+			uint64_t fitting{ 0 };
+			while (orientations)
+			{
+				uint64_t lowest{ orientations & (~orientations + 1) };
+				fitting |= uint64_t{ 1 } << popCount64(valid & (lowest - 1));
+				orientations &= orientations - 1;
+			}
+			return fitting;
+		}
+		int count{ table.firstCandidate[cell + 1] - table.firstCandidate[cell] };
+		int maskStride{ (table.firstMask[cell + 1] - table.firstMask[cell]) / Words };
+		return mFitTest(table.masks.data() + table.firstMask[cell], maskStride, count, Words, mFree.words);
+	}
+
+	// If the piece is available, returns true and places it on the board
+	// Precondition: the candidate fits on the open cells
+	template <int Words, int Width, int Height>
+	bool BitBoardSolver<Words, Width, Height>::tryPlace(const Candidate& candidate)
+	{
+		if (mMinimizeRepeats && !isPieceAvailable(candidate.base))
+			return false;
+
+		mFree -= candidate.mask;
+		++mPieceCounts[candidate.base];
+		mPlaced.push_back(&candidate);
+		return true;
+	}
+
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::removeLast()
+	{
+		const Candidate& last{ *mPlaced.back() };
+		mFree |= last.mask;
+		--mPieceCounts[last.base];
+		mPlaced.pop_back();
+	}
+
+	// Without repeats, every piece has to be used once before any piece is used again.
+	// Boards of 60 cells or fewer therefore never repeat a piece.
+	template <int Words, int Width, int Height>
+	bool BitBoardSolver<Words, Width, Height>::isPieceAvailable(int base) const
+	{
+		int round{ static_cast<int>(mPlaced.size()) / Pentomino::cTotalBasePieces };
+		return mPieceCounts[base] <= round;
+	}
+
+	template <int Words, int Width, int Height>
+	typename BitBoardSolver<Words, Width, Height>::Board BitBoardSolver<Words, Width, Height>::getCoverage() const
+	{
+		Board coverage{};
+		for (const Candidate& candidate : mCandidates->candidates)
+			coverage |= candidate.mask;
+		return coverage;
+	}
+
+	// Every piece but X covers 3 cells of one checkerboard color and 2 of the other, and X covers 4 and 1.
+	// An island of k pieces with d more cells of one color than the other therefore needs (d - k) / 2 X pieces.
+	template <int Words, int Width, int Height>
+	bool BitBoardSolver<Words, Width, Height>::isPossibleSolution() const
+	{
+		Board smallestIsland{};
+		return isPossibleSolution(smallestIsland);
+	}
+
+	// Also sets smallestIsland to the island with the fewest cells, the first one found on ties
+	template <int Words, int Width, int Height>
+	bool BitBoardSolver<Words, Width, Height>::isPossibleSolution(Board& smallestIsland) const
+	{
+		constexpr int cX{ static_cast<int>(OrientationBase::X) };
+		int pieces{ mFree.popCount() / 5 };
+		int xAvailable{ pieces };
+		if (mMinimizeRepeats)
+		{
+			// Each round of 12 pieces uses X once, so a solution of n pieces has at most ceil(n / 12) of them
+			int total{ static_cast<int>(mPlaced.size()) + pieces };
+			xAvailable = (total + Pentomino::cTotalBasePieces - 1) / Pentomino::cTotalBasePieces - mPieceCounts[cX];
+		}
+
+		int xNeeded{ 0 };
+		int smallestArea{ 0 };
+		Board remaining{ mFree };
+		while (!remaining.isEmpty())
+		{
+			Board island{ findIsland(remaining.lowestBit(), remaining) };
+			int area{ island.popCount() };
+			if (area % 5 != 0)
+				return false;
+			if (smallestArea == 0 || area < smallestArea)
+			{
+				smallestIsland = island;
+				smallestArea = area;
+			}
+			int imbalance{ std::abs(2 * (island & mBlackCells).popCount() - area) };
+			if (imbalance > 3 * (area / 5))
+				return false;
+			if (imbalance > area / 5)
+			{
+				xNeeded += (imbalance - area / 5) / 2;
+				if (xNeeded > xAvailable)
+					return false;
+			}
+			remaining -= island;
+		}
+		return true;
+	}
+
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::getSolution(int64_t i, Solution& solution) const
+	{
+		decodeSolution(mSolutions[i], solution);
+	}
+
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::decodeSolution(const Candidate* const* placed, Solution& solution) const
+	{
+		solution.clear();
+		char symbol{ 'A' };
+		for (int i = 0; i < mSolutions.getRecordSize(); i++)
+			solution.emplace_back(Pentomino(placed[i]->boardOrientation), Point(placed[i]->x, placed[i]->y), symbol++);
+	}
+
+	// Cells of open connected to the seed
+	template <int Words, int Width, int Height>
+	typename BitBoardSolver<Words, Width, Height>::Board BitBoardSolver<Words, Width, Height>::findIsland(const Board& seed, const Board& open) const
+	{
+		if constexpr (cIsSpecialized)
+			return Board::template floodFill<Width + 1>(seed, open);
+		else
+			return Board::floodFill(seed, open, getStride());
+	}
+
+	template <int Words, int Width, int Height>
+	uint64_t BitBoardSolver<Words, Width, Height>::getFirstOrientations() const
+	{
+		int firstCell{ mFree.findFirst() };
+		return firstCell < 0 ? 0 : mCandidates->validOrientations[firstCell];
+	}
+
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::reportNodes()
+	{
+		mNodeCounter->fetch_add(mUnreportedNodes, std::memory_order_relaxed);
+		mUnreportedNodes = 0;
+	}
+
+	template <int Words, int Width, int Height>
+	void BitBoardSolver<Words, Width, Height>::recordSolution()
+	{
+		if (mOnSolution)
+		{
+			decodeSolution(mPlaced.data(), mSolutionBuffer);
+			AllocationScope scope{ AllocationPhase::SolutionHandling };
+			mStopped = !mOnSolution(mSolutionBuffer);
+		}
+		else
+		{
+			AllocationScope scope{ AllocationPhase::SolutionStorage };
+			std::copy(mPlaced.begin(), mPlaced.end(), mSolutions.allocate());
+		}
+#if DEBUG_LEVEL > 1
+		std::cout << "Solution found!\n";
+#endif
+	}
+
+	template class BitBoardSolver<1>;
+	template class BitBoardSolver<2>;
+	template class BitBoardSolver<4>;
+	template class BitBoardSolver<8>;
+
+#define PENTOMINO_INSTANTIATE_SPECIALIZED(width, height) template class BitBoardSolver<wordsForBoard(width, height), width, height>;
+	PENTOMINO_SPECIALIZED_DIMENSIONS(PENTOMINO_INSTANTIATE_SPECIALIZED)
+#undef PENTOMINO_INSTANTIATE_SPECIALIZED
+}
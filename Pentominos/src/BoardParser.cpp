@@ -0,0 +1,183 @@
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "BoardParser.h"
+
+namespace Pentominoes
+{
+	bool BoardParser::next(PentominoBoard& board)
+	{
+		// Skip blank lines before the board
+		while (mCursor < mEnd && (*mCursor == '\n' || *mCursor == '\r'))
+			++mCursor;
+		if (mCursor == mEnd)
+			return false;
+
+		// Find the lines of the board and the bounding box of its holes
+		mLines.clear();
+		int minRow{ -1 };
+		int maxRow{ -1 };
+		int minCol{ -1 };
+		int maxCol{ -1 };
+		while (mCursor < mEnd)
+		{
+			const char* newLine{ static_cast<const char*>(std::memchr(mCursor, '\n', mEnd - mCursor)) };
+			const char* lineEnd{ newLine ? newLine : mEnd };
+			Line line{ mCursor, static_cast<int>(lineEnd - mCursor) };
+			mCursor = newLine ? newLine + 1 : mEnd;
+			if (line.length > 0 && line.start[line.length - 1] == '\r')
+				--line.length;
+			if (line.length == 0)
+				break;
+
+			const char* firstHole{ static_cast<const char*>(std::memchr(line.start, '0', line.length)) };
+			if (firstHole)
+			{
+				int lastHole{ line.length - 1 };
+				while (line.start[lastHole] != '0')
+					--lastHole;
+				int row{ static_cast<int>(mLines.size()) };
+				if (minRow < 0)
+					minRow = row;
+				maxRow = row;
+				int firstCol{ static_cast<int>(firstHole - line.start) };
+				if (minCol < 0 || firstCol < minCol)
+					minCol = firstCol;
+				if (lastHole > maxCol)
+					maxCol = lastHole;
+			}
+			mLines.push_back(line);
+		}
+
+		if (minRow < 0)
+		{
+			board = PentominoBoard{ std::string{}, 0, 0 };
+			return true;
+		}
+
+		// Copy the holes into the trimmed grid, everything else is a wall
+		int width{ maxCol - minCol + 1 };
+		int height{ maxRow - minRow + 1 };
+		std::string cells(static_cast<std::size_t>(width) * height, '1');
+		for (int row = 0; row < height; row++)
+		{
+			const Line& line{ mLines[minRow + row] };
+			int end{ line.length < maxCol + 1 ? line.length : maxCol + 1 };
+			for (int col = minCol; col < end; col++)
+			{
+				if (line.start[col] == '0')
+					cells[row * width + col - minCol] = '0';
+			}
+		}
+		board = PentominoBoard{ std::move(cells), width, height };
+		return true;
+	}
+
+	std::vector<PentominoBoard> BoardParser::parseAll(const char* data, std::size_t size)
+	{
+		std::vector<PentominoBoard> boards{};
+		BoardParser parser{ data, size };
+		PentominoBoard board{};
+		while (parser.next(board))
+			boards.push_back(board);
+		return boards;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open(const std::string& path)
+	{
+		close();
+#if defined(_WIN32)
+		mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (mFile == INVALID_HANDLE_VALUE)
+		{
+			mFile = nullptr;
+			return false;
+		}
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(mFile, &size))
+		{
+			close();
+			return false;
+		}
+		mSize = static_cast<std::size_t>(size.QuadPart);
+		if (mSize == 0)
+			return true; // Empty files can't be mapped
+		mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mMapping)
+		{
+			close();
+			return false;
+		}
+		mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+		if (!mData)
+		{
+			close();
+			return false;
+		}
+#else
+		int file{ ::open(path.c_str(), O_RDONLY) };
+		if (file < 0)
+			return false;
+		struct stat info {};
+		if (fstat(file, &info) != 0)
+		{
+			::close(file);
+			return false;
+		}
+		mSize = static_cast<std::size_t>(info.st_size);
+		if (mSize > 0)
+		{
+			void* data{ mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0) };
+			if (data == MAP_FAILED)
+			{
+				::close(file);
+				mSize = 0;
+				return false;
+			}
+			mData = static_cast<const char*>(data);
+		}
+		::close(file); // The mapping stays valid after closing the descriptor
+#endif
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+#if defined(_WIN32)
+		if (mData)
+			UnmapViewOfFile(mData);
+		if (mMapping)
+			CloseHandle(mMapping);
+		if (mFile)
+			CloseHandle(mFile);
+		mMapping = nullptr;
+		mFile = nullptr;
+#else
+		if (mData)
+			munmap(const_cast<char*>(mData), mSize);
+#endif
+		mData = nullptr;
+		mSize = 0;
+	}
+
+	std::vector<PentominoBoard> loadBoardFile(const std::string& path)
+	{
+		MappedFile file{};
+		if (!file.open(path))
+			return {};
+		return BoardParser::parseAll(file.getData(), file.getSize());
+	}
+}
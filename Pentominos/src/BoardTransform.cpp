@@ -0,0 +1,67 @@
+#include "BoardTransform.h"
+
+namespace Pentominoes
+{
+	CellTransform::CellTransform(BoardTransform transform, int width, int height)
+		: mSource(width * height),
+		mWidth{ swapsDimensions(transform) ? height : width },
+		mHeight{ swapsDimensions(transform) ? width : height }
+	{
+		for (int row = 0; row < mHeight; row++)
+		{
+			for (int col = 0; col < mWidth; col++)
+			{
+				// Cell of the original board that moves to (row, col)
+				int sourceRow{ row };
+				int sourceCol{ col };
+				switch (transform)
+				{
+				case BoardTransform::Rotate90:
+					sourceRow = height - 1 - col;
+					sourceCol = row;
+					break;
+				case BoardTransform::Rotate180:
+					sourceRow = height - 1 - row;
+					sourceCol = width - 1 - col;
+					break;
+				case BoardTransform::Rotate270:
+					sourceRow = col;
+					sourceCol = width - 1 - row;
+					break;
+				case BoardTransform::ReflectHorizontal:
+					sourceRow = height - 1 - row;
+					break;
+				case BoardTransform::ReflectVertical:
+					sourceCol = width - 1 - col;
+					break;
+				case BoardTransform::ReflectDiagonal:
+					sourceRow = col;
+					sourceCol = row;
+					break;
+				case BoardTransform::ReflectAntidiagonal:
+					sourceRow = height - 1 - col;
+					sourceCol = width - 1 - row;
+					break;
+				default:
+					break;
+				}
+				mSource[row * mWidth + col] = sourceRow * width + sourceCol;
+			}
+		}
+	}
+
+	void relabelCells(char* cells, int count)
+	{
+		char labels[256]{};
+		char next{ 'A' };
+		for (int i = 0; i < count; i++)
+		{
+			unsigned char cell{ static_cast<unsigned char>(cells[i]) };
+			if (cell == '0' || cell == '1')
+				continue;
+			if (!labels[cell])
+				labels[cell] = next++;
+			cells[i] = labels[cell];
+		}
+	}
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <iterator>
+
+#include "CompressedBitmap.h"
+#include "BitBoard.h"
+
+namespace Pentominoes
+{
+	void CompressedBitmap::append(uint32_t id)
+	{
+		uint16_t key{ static_cast<uint16_t>(id >> 16) };
+		uint16_t low{ static_cast<uint16_t>(id) };
+		if (mChunks.empty() || mChunks.back().key != key)
+		{
+			mChunks.emplace_back();
+			mChunks.back().key = key;
+		}
+		Chunk& chunk{ mChunks.back() };
+		if (!chunk.isBitset() && chunk.count == cMaxArraySize)
+			chunk.toBitset();
+		if (chunk.isBitset())
+			chunk.bits[low >> 6] |= uint64_t{ 1 } << (low & 63);
+		else
+			chunk.array.push_back(low);
+		++chunk.count;
+	}
+
+	bool CompressedBitmap::contains(uint32_t id) const
+	{
+		uint16_t key{ static_cast<uint16_t>(id >> 16) };
+		auto chunk{ std::lower_bound(mChunks.begin(), mChunks.end(), key, [](const Chunk& c, uint16_t k) { return c.key < k; }) };
+		return chunk != mChunks.end() && chunk->key == key && chunk->contains(static_cast<uint16_t>(id));
+	}
+
+	int64_t CompressedBitmap::size() const
+	{
+		int64_t total{ 0 };
+		for (const Chunk& chunk : mChunks)
+			total += chunk.count;
+		return total;
+	}
+
+	std::size_t CompressedBitmap::getBytes() const
+	{
+		std::size_t bytes{ mChunks.size() * sizeof(Chunk) };
+		for (const Chunk& chunk : mChunks)
+			bytes += chunk.array.capacity() * sizeof(uint16_t) + chunk.bits.capacity() * sizeof(uint64_t);
+		return bytes;
+	}
+
+	std::vector<uint32_t> CompressedBitmap::toVector() const
+	{
+		std::vector<uint32_t> ids{};
+		ids.reserve(size());
+		for (const Chunk& chunk : mChunks)
+		{
+			uint32_t high{ static_cast<uint32_t>(chunk.key) << 16 };
+			if (!chunk.isBitset())
+			{
+				for (uint16_t low : chunk.array)
+					ids.push_back(high | low);
+				continue;
+			}
+			for (int w = 0; w < cBitsetWords; w++)
+			{
+				for (uint64_t word = chunk.bits[w]; word; word &= word - 1)
+					ids.push_back(high | static_cast<uint32_t>(w * 64 + countTrailingZeros64(word)));
+			}
+		}
+		return ids;
+	}
+
+	CompressedBitmap& CompressedBitmap::operator&=(const CompressedBitmap& other)
+	{
+		std::vector<Chunk> result{};
+		auto a{ mChunks.begin() };
+		auto b{ other.mChunks.begin() };
+		while (a != mChunks.end() && b != other.mChunks.end())
+		{
+			if (a->key < b->key)
+				++a;
+			else if (b->key < a->key)
+				++b;
+			else
+			{
+				Chunk chunk{ intersect(*a, *b) };
+				if (chunk.count > 0)
+					result.push_back(std::move(chunk));
+				++a;
+				++b;
+			}
+		}
+		mChunks = std::move(result);
+		return *this;
+	}
+
+	CompressedBitmap& CompressedBitmap::operator|=(const CompressedBitmap& other)
+	{
+		std::vector<Chunk> result{};
+		result.reserve(mChunks.size() + other.mChunks.size());
+		auto a{ mChunks.begin() };
+		auto b{ other.mChunks.begin() };
+		while (a != mChunks.end() || b != other.mChunks.end())
+		{
+			if (b == other.mChunks.end() || (a != mChunks.end() && a->key < b->key))
+				result.push_back(std::move(*a++));
+			else if (a == mChunks.end() || b->key < a->key)
+				result.push_back(*b++);
+			else
+				result.push_back(unite(*a++, *b++));
+		}
+		mChunks = std::move(result);
+		return *this;
+	}
+
+	bool CompressedBitmap::Chunk::contains(uint16_t low) const
+	{
+		if (isBitset())
+			return (bits[low >> 6] >> (low & 63)) & 1;
+		return std::binary_search(array.begin(), array.end(), low);
+	}
+
+	void CompressedBitmap::Chunk::toBitset()
+	{
+		bits.assign(cBitsetWords, 0);
+		for (uint16_t low : array)
+			bits[low >> 6] |= uint64_t{ 1 } << (low & 63);
+		std::vector<uint16_t>{}.swap(array);
+	}
+
+	void CompressedBitmap::Chunk::toArrayIfSmall()
+	{
+		if (!isBitset() || count > cMaxArraySize)
+			return;
+		array.reserve(count);
+		for (int w = 0; w < cBitsetWords; w++)
+		{
+			for (uint64_t word = bits[w]; word; word &= word - 1)
+				array.push_back(static_cast<uint16_t>(w * 64 + countTrailingZeros64(word)));
+		}
+		std::vector<uint64_t>{}.swap(bits);
+	}
+
+	// Precondition: a.key == b.key
+	CompressedBitmap::Chunk CompressedBitmap::intersect(const Chunk& a, const Chunk& b)
+	{
+		Chunk result{};
+		result.key = a.key;
+		if (a.isBitset() && b.isBitset())
+		{
+			result.bits.resize(cBitsetWords);
+			for (int w = 0; w < cBitsetWords; w++)
+			{
+				result.bits[w] = a.bits[w] & b.bits[w];
+				result.count += popCount64(result.bits[w]);
+			}
+			result.toArrayIfSmall();
+			return result;
+		}
+
+		const Chunk& small{ a.isBitset() || (!b.isBitset() && b.count < a.count) ? b : a };
+		const Chunk& large{ &small == &a ? b : a };
+		if (large.isBitset())
+		{
+			for (uint16_t low : small.array)
+			{
+				if (large.contains(low))
+					result.array.push_back(low);
+			}
+		}
+		else if (large.count / 32 > small.count)
+		{
+			// Much smaller: binary search each id instead of walking the large array
+			auto from{ large.array.begin() };
+			for (uint16_t low : small.array)
+			{
+				from = std::lower_bound(from, large.array.end(), low);
+				if (from == large.array.end())
+					break;
+				if (*from == low)
+					result.array.push_back(low);
+			}
+		}
+		else
+			std::set_intersection(small.array.begin(), small.array.end(), large.array.begin(), large.array.end(), std::back_inserter(result.array));
+		result.count = static_cast<int32_t>(result.array.size());
+		return result;
+	}
+
+	// Precondition: a.key == b.key
+	CompressedBitmap::Chunk CompressedBitmap::unite(const Chunk& a, const Chunk& b)
+	{
+		Chunk result{};
+		result.key = a.key;
+		if (!a.isBitset() && !b.isBitset())
+		{
+			std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(result.array));
+			result.count = static_cast<int32_t>(result.array.size());
+			if (result.count > cMaxArraySize)
+				result.toBitset();
+			return result;
+		}
+
+		result.bits.assign(cBitsetWords, 0);
+		for (const Chunk* chunk : { &a, &b })
+		{
+			if (chunk->isBitset())
+			{
+				for (int w = 0; w < cBitsetWords; w++)
+					result.bits[w] |= chunk->bits[w];
+			}
+			else
+			{
+				for (uint16_t low : chunk->array)
+					result.bits[low >> 6] |= uint64_t{ 1 } << (low & 63);
+			}
+		}
+		for (int w = 0; w < cBitsetWords; w++)
+			result.count += popCount64(result.bits[w]);
+		return result;
+	}
+}
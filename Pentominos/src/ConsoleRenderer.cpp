@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#include "ConsoleRenderer.h"
+
+namespace Pentominoes
+{
+	namespace
+	{
+		// ANSI SGR codes for the 16 console colors, indexed like the Windows console palette
+		// (bit 0 blue, bit 1 green, bit 2 red, bit 3 bright)
+		constexpr int cForegroundCodes[16]{ 30, 34, 32, 36, 31, 35, 33, 37, 90, 94, 92, 96, 91, 95, 93, 97 };
+
+		// Palette index of the background for a cell, or -1 for the default colors
+		int getCellColor(char cell)
+		{
+			if (cell >= 'A')
+			{
+				int color{ ((cell - 'A') % 14) + 1 }; // skip 0 (black)
+				if (color > 7) // skip 8 (dark gray), reserved for 1s
+					color++;
+				return color;
+			}
+			if (cell == '1')
+				return 8;
+			return -1;
+		}
+
+		void appendColor(std::string& out, int color)
+		{
+			if (color < 0)
+			{
+				out += "\x1b[0m";
+				return;
+			}
+			// Same color in front and behind, so each cell is a solid block
+			out += "\x1b[";
+			out += std::to_string(cForegroundCodes[color]);
+			out += ';';
+			out += std::to_string(cForegroundCodes[color] + 10);
+			out += 'm';
+		}
+	}
+
+	const ConsoleRenderer& ConsoleRenderer::get()
+	{
+		static const ConsoleRenderer renderer{};
+		return renderer;
+	}
+
+	ConsoleRenderer::ConsoleRenderer()
+	{
+#if defined(_WIN32)
+		HANDLE console{ GetStdHandle(STD_OUTPUT_HANDLE) };
+		DWORD mode{};
+		if (_isatty(_fileno(stdout)) && GetConsoleMode(console, &mode))
+			mUseColor = SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) != 0;
+		CONSOLE_SCREEN_BUFFER_INFO info{};
+		if (GetConsoleScreenBufferInfo(console, &info))
+			mColumns = info.srWindow.Right - info.srWindow.Left + 1;
+#else
+		mUseColor = isatty(STDOUT_FILENO);
+		winsize size{};
+		if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0)
+			mColumns = size.ws_col;
+#endif
+	}
+
+	void ConsoleRenderer::appendLine(std::string& out, const std::string& cells, int width, int row) const
+	{
+		if (!mUseColor)
+		{
+			out.append(cells, static_cast<size_t>(row) * width, width);
+			return;
+		}
+
+		// Only emit an escape when the color changes
+		int current{ -1 };
+		for (int i = row * width; i < (row + 1) * width; i++)
+		{
+			int color{ getCellColor(cells[i]) };
+			if (color != current)
+			{
+				appendColor(out, color);
+				current = color;
+			}
+			out += cells[i];
+		}
+		if (current >= 0)
+			appendColor(out, -1);
+	}
+
+	void ConsoleRenderer::printBoard(const std::string& cells, int width, int height) const
+	{
+		std::string out{};
+		for (int row = 0; row < height; row++)
+		{
+			appendLine(out, cells, width, row);
+			out += '\n';
+		}
+		out += '\n';
+		write(out);
+	}
+
+	void ConsoleRenderer::printBoards(const std::vector<const std::string*>& boards, int width, int height) const
+	{
+		if (boards.empty())
+			return;
+		int boardsPerRow{ std::max(mColumns / (width + 1), 1) };
+		int rows{ static_cast<int>((boards.size() + boardsPerRow - 1) / boardsPerRow) };
+		int threadCount{ std::max(static_cast<int>(std::thread::hardware_concurrency()), 1) };
+
+		// Format up to one page per thread, then write the pages in order
+		std::vector<std::string> pages(threadCount);
+		for (int firstRow = 0; firstRow < rows; firstRow += cRowsPerPage * threadCount)
+		{
+			int pageCount{ std::min(threadCount, (rows - firstRow + cRowsPerPage - 1) / cRowsPerPage) };
+			auto formatPage = [&](int page)
+			{
+				int pageFirstRow{ firstRow + page * cRowsPerPage };
+				pages[page].clear();
+				formatRows(pages[page], boards, pageFirstRow, std::min(pageFirstRow + cRowsPerPage, rows), boardsPerRow, width, height);
+			};
+
+			if (pageCount == 1)
+			{
+				formatPage(0);
+			}
+			else
+			{
+				std::vector<std::thread> threads{};
+				for (int page = 0; page < pageCount; page++)
+					threads.emplace_back(formatPage, page);
+				for (std::thread& thread : threads)
+				{
+					thread.join();
+				}
+			}
+			for (int page = 0; page < pageCount; page++)
+				write(pages[page]);
+		}
+	}
+
+	// Rows [firstRow, lastRow) of boards, each a line of every board in the row followed by a blank line
+	void ConsoleRenderer::formatRows(std::string& out, const std::vector<const std::string*>& boards, int firstRow, int lastRow,
+		int boardsPerRow, int width, int height) const
+	{
+		for (int row = firstRow; row < lastRow; row++)
+		{
+			int first{ row * boardsPerRow };
+			int last{ std::min(first + boardsPerRow, static_cast<int>(boards.size())) };
+			for (int line = 0; line < height; line++)
+			{
+				for (int i = first; i < last; i++)
+				{
+					appendLine(out, *boards[i], width, line);
+					out += ' ';
+				}
+				out += '\n';
+			}
+			out += '\n';
+		}
+	}
+
+	void ConsoleRenderer::write(const std::string& buffer)
+	{
+		// std::cout is synced with stdout, so a large fwrite goes out as one write after it
+		std::cout.flush();
+		std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+		std::fflush(stdout);
+	}
+}
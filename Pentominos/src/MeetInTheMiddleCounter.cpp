@@ -0,0 +1,278 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "MeetInTheMiddleCounter.h"
+#include "Debug.h"
+
+namespace Pentominoes
+{
+	MeetInTheMiddleCounter::MeetInTheMiddleCounter(const PentominoBoard& board, bool minimizeRepeats)
+		: mLayout{ board }, mMinimizeRepeats{ minimizeRepeats }
+	{
+		mCut = chooseCut();
+		mCutCell = mCut * mLayout.getSpan();
+		mZoneCells = 4 * mLayout.getSpan();
+		if (mZoneCells > mLayout.getTotalCells() - mCutCell)
+			mZoneCells = mLayout.getTotalCells() - mCutCell;
+	}
+
+	bool MeetInTheMiddleCounter::canCount() const
+	{
+		if (mLayout.getSpan() > SweepLayout::cMaxSpan || mLayout.getLength() < 2)
+			return false;
+		if (mMinimizeRepeats && mLayout.getOpenCells() > cMaxNoRepeatCells)
+			return false;
+		return true;
+	}
+
+	// Pick the cut with the fewest open cells that left half pieces can reach across it,
+	// among the cuts that keep the halves reasonably balanced. Narrow waists keep the
+	// number of distinct signatures down, and balanced halves keep both searches small.
+	int MeetInTheMiddleCounter::chooseCut() const
+	{
+		int length{ mLayout.getLength() };
+		int span{ mLayout.getSpan() };
+		int totalOpen{ mLayout.getOpenCells() };
+
+		int bestCut{ length / 2 };
+		int bestZoneOpen{ -1 };
+		int bestImbalance{ 0 };
+		int leftOpen{ 0 };
+		for (int cut = 1; cut < length; cut++)
+		{
+			for (int row = 0; row < span; row++)
+			{
+				if (!mLayout.isWall((cut - 1) * span + row))
+					++leftOpen;
+			}
+			int rightOpen{ totalOpen - leftOpen };
+			if (leftOpen * 3 < totalOpen || rightOpen * 3 < totalOpen)
+				continue;
+
+			int zoneOpen{ 0 };
+			for (int cell = cut * span; cell < (cut + 4) * span && cell < mLayout.getTotalCells(); cell++)
+			{
+				if (!mLayout.isWall(cell))
+					++zoneOpen;
+			}
+			int imbalance{ std::abs(leftOpen - rightOpen) };
+			if (bestZoneOpen < 0 || zoneOpen < bestZoneOpen || (zoneOpen == bestZoneOpen && imbalance < bestImbalance))
+			{
+				bestCut = cut;
+				bestZoneOpen = zoneOpen;
+				bestImbalance = imbalance;
+			}
+		}
+		return bestCut;
+	}
+
+	WideCount MeetInTheMiddleCounter::count(bool multithreading)
+	{
+		SignatureCounts leftSignatures{ countHalf(false, multithreading) };
+		buildCrossingPrefixes(leftSignatures);
+		SignatureCounts rightSignatures{ countHalf(true, multithreading) };
+
+#if DEBUG_LEVEL > 0
+		std::cout << "Cut at column " << mCut << ": " << leftSignatures.size() << " left signatures, "
+			<< rightSignatures.size() << " right signatures\n";
+#endif
+
+		// Hash join on the crossing cells
+		std::unordered_map<uint64_t, std::vector<std::pair<int, WideCount>>> leftByCrossing{};
+		for (const auto& entry : leftSignatures)
+		{
+			uint64_t crossing{ entry.first >> cPieceSetBits };
+			int pieceSet{ static_cast<int>(entry.first & ((1 << cPieceSetBits) - 1)) };
+			leftByCrossing[crossing].emplace_back(pieceSet, entry.second);
+		}
+
+		WideCount total{};
+		for (const auto& entry : rightSignatures)
+		{
+			uint64_t crossing{ entry.first >> cPieceSetBits };
+			int pieceSet{ static_cast<int>(entry.first & ((1 << cPieceSetBits) - 1)) };
+			auto matches{ leftByCrossing.find(crossing) };
+			if (matches == leftByCrossing.end())
+				continue;
+
+			for (const auto& left : matches->second)
+			{
+				// Piece sets are only tracked when minimizing repeats, and are 0 otherwise
+				if ((left.first & pieceSet) == 0)
+					total += left.second * entry.second;
+			}
+		}
+		return total;
+	}
+
+	// Enumerate every partial tiling of one half, splitting the branches at the first
+	// cell across threads if multithreading.
+	MeetInTheMiddleCounter::SignatureCounts MeetInTheMiddleCounter::countHalf(bool isRight, bool multithreading) const
+	{
+		HalfState root{};
+		root.covered.resize(mLayout.getTotalCells());
+		int start{ findNextCell(root, isRight ? mCutCell : 0, isRight) };
+
+		SignatureCounts signatures{};
+		if (!multithreading)
+		{
+			searchHalf(root, start, isRight, signatures);
+			return signatures;
+		}
+
+		// Each thread gets its own copy of the state and its own signature map
+		std::vector<int> choices{};
+		if (isRight && start - mCutCell < mZoneCells)
+			choices.push_back(cSkipCell);
+		for (int i = 0; i < static_cast<int>(mLayout.getPlacements().size()); i++)
+			choices.push_back(i);
+
+		std::vector<HalfState> branches(choices.size(), root);
+		std::vector<SignatureCounts> partialSignatures(choices.size());
+		std::vector<std::thread> threads{};
+		for (int i = 0; i < static_cast<int>(choices.size()); i++)
+		{
+			if (start < (isRight ? mLayout.getTotalCells() : mCutCell) && applyChoice(branches[i], start, choices[i], isRight))
+				threads.emplace_back(&MeetInTheMiddleCounter::searchHalf, this, std::ref(branches[i]), start + 1,
+					isRight, std::ref(partialSignatures[i]));
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		if (start == (isRight ? mLayout.getTotalCells() : mCutCell))
+			searchHalf(root, start, isRight, signatures); // Nothing to place in this half
+		for (const SignatureCounts& partial : partialSignatures)
+		{
+			for (const auto& entry : partial)
+				signatures[entry.first] += entry.second;
+		}
+		return signatures;
+	}
+
+	// Recursive backtracking over one half, recording the signature of each complete partial tiling
+	void MeetInTheMiddleCounter::searchHalf(HalfState& state, int cell, bool isRight, SignatureCounts& signatures) const
+	{
+		cell = findNextCell(state, cell, isRight);
+		int endCell{ isRight ? mLayout.getTotalCells() : mCutCell };
+		if (cell == endCell)
+		{
+			signatures[makeKey(state.crossing, state.pieceSet)] += 1;
+			return;
+		}
+
+		// The right half may leave cells in reach of the left half uncovered
+		if (isRight && cell - mCutCell < mZoneCells && applyChoice(state, cell, cSkipCell, isRight))
+		{
+			searchHalf(state, cell + 1, isRight, signatures);
+			undoChoice(state, cell, cSkipCell);
+		}
+
+		for (int i = 0; i < static_cast<int>(mLayout.getPlacements().size()); i++)
+		{
+			if (applyChoice(state, cell, i, isRight))
+			{
+				searchHalf(state, cell + 1, isRight, signatures);
+				undoChoice(state, cell, i);
+			}
+		}
+	}
+
+	int MeetInTheMiddleCounter::findNextCell(const HalfState& state, int cell, bool isRight) const
+	{
+		int endCell{ isRight ? mLayout.getTotalCells() : mCutCell };
+		while (cell < endCell && (mLayout.isWall(cell) || state.covered[cell]))
+			++cell;
+		return cell;
+	}
+
+	// If the choice is legal at the cell, returns true and applies it to the state
+	bool MeetInTheMiddleCounter::applyChoice(HalfState& state, int cell, int choice, bool isRight) const
+	{
+		int zoneIndex{ cell - mCutCell };
+		if (choice == cSkipCell)
+		{
+			state.covered[cell] = true;
+			state.crossing |= uint64_t{ 1 } << zoneIndex;
+		}
+		else
+		{
+			const SweepPlacement& placement{ mLayout.getPlacements()[choice] };
+			if (!mLayout.isInBounds(placement, cell))
+				return false;
+			if (mMinimizeRepeats && ((state.pieceSet >> placement.base) & 1))
+				return false;
+			for (int offset : placement.offsets)
+			{
+				if (mLayout.isWall(cell + offset) || state.covered[cell + offset])
+					return false;
+			}
+
+			for (int offset : placement.offsets)
+			{
+				state.covered[cell + offset] = true;
+				if (!isRight && cell + offset >= mCutCell)
+					state.crossing |= uint64_t{ 1 } << (cell + offset - mCutCell);
+			}
+			if (mMinimizeRepeats)
+				state.pieceSet |= 1 << placement.base;
+		}
+
+		// Every cell up to this one is now decided, so the right half's crossing cells
+		// so far must match the start of some left half's crossing cells.
+		if (isRight && zoneIndex < mZoneCells && !isConsistentPrefix(zoneIndex + 1, state.crossing))
+		{
+			undoChoice(state, cell, choice);
+			return false;
+		}
+		return true;
+	}
+
+	// Precondition: applyChoice() returned true for the same arguments
+	void MeetInTheMiddleCounter::undoChoice(HalfState& state, int cell, int choice) const
+	{
+		if (choice == cSkipCell)
+		{
+			state.covered[cell] = false;
+			state.crossing &= ~(uint64_t{ 1 } << (cell - mCutCell));
+			return;
+		}
+
+		const SweepPlacement& placement{ mLayout.getPlacements()[choice] };
+		for (int offset : placement.offsets)
+		{
+			state.covered[cell + offset] = false;
+			if (cell + offset >= mCutCell && cell < mCutCell)
+				state.crossing &= ~(uint64_t{ 1 } << (cell + offset - mCutCell));
+		}
+		if (mMinimizeRepeats)
+			state.pieceSet &= ~(1 << placement.base);
+	}
+
+	bool MeetInTheMiddleCounter::isConsistentPrefix(int length, uint64_t crossing) const
+	{
+		uint64_t prefix{ crossing & ((uint64_t{ 1 } << length) - 1) };
+		return mCrossingPrefixes.count((static_cast<uint64_t>(length) << 48) | prefix) > 0;
+	}
+
+	void MeetInTheMiddleCounter::buildCrossingPrefixes(const SignatureCounts& leftSignatures)
+	{
+		mCrossingPrefixes.clear();
+		for (const auto& entry : leftSignatures)
+		{
+			uint64_t crossing{ entry.first >> cPieceSetBits };
+			for (int length = 1; length <= mZoneCells; length++)
+			{
+				uint64_t prefix{ crossing & ((uint64_t{ 1 } << length) - 1) };
+				mCrossingPrefixes.insert((static_cast<uint64_t>(length) << 48) | prefix);
+			}
+		}
+	}
+
+	uint64_t MeetInTheMiddleCounter::makeKey(uint64_t crossing, int pieceSet) const
+	{
+		return (crossing << cPieceSetBits) | static_cast<uint64_t>(pieceSet);
+	}
+}
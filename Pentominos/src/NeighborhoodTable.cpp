@@ -0,0 +1,54 @@
+#include <cstddef>
+
+#include "NeighborhoodTable.h"
+
+namespace Pentominoes
+{
+	const NeighborhoodTable& NeighborhoodTable::get()
+	{
+		static const NeighborhoodTable table{};
+		return table;
+	}
+
+	NeighborhoodTable::NeighborhoodTable()
+		: mUpper(std::size_t{ 1 } << cUpperBits), mLower(std::size_t{ 1 } << cLowerBits)
+	{
+		// Bits each orientation needs open in the upper and lower indices
+		uint32_t upperNeeds[63]{};
+		uint32_t lowerNeeds[63]{};
+		for (int i = 0; i < 63; i++)
+		{
+			const OrientationData& data{ cOrientationTable.orientations[i] };
+			for (const PieceCell& cell : data.cells)
+			{
+				int dx{ cell.x - data.xOffset };
+				if (cell.y == 0 && dx == 0)
+					continue;
+				int bit{ dx - cRowFirstDx[cell.y] };
+				for (int row = cell.y < cUpperRows ? 0 : cUpperRows; row < cell.y; row++)
+					bit += cRowWidth[row];
+				if (cell.y < cUpperRows)
+					upperNeeds[i] |= uint32_t{ 1 } << bit;
+				else
+					lowerNeeds[i] |= uint32_t{ 1 } << bit;
+			}
+		}
+
+		for (uint32_t index = 0; index < mUpper.size(); index++)
+		{
+			for (int i = 0; i < 63; i++)
+			{
+				if ((upperNeeds[i] & ~index) == 0)
+					mUpper[index] |= uint64_t{ 1 } << i;
+			}
+		}
+		for (uint32_t index = 0; index < mLower.size(); index++)
+		{
+			for (int i = 0; i < 63; i++)
+			{
+				if ((lowerNeeds[i] & ~index) == 0)
+					mLower[index] |= uint64_t{ 1 } << i;
+			}
+		}
+	}
+}
@@ -1,27 +1,278 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include "PentominoSolver.h"
+#include "AllocationTracker.h"
+#include "BitBoardSolver.h"
+#include "ConsoleRenderer.h"
+#include "MeetInTheMiddleCounter.h"
+#include "SolutionCanonicalizer.h"
+#include "SolutionPipeline.h"
+#include "SolutionStatistics.h"
+#include "ThreadPool.h"
+#include "TransferMatrixCounter.h"
 #include "Debug.h"
 
 
 namespace Pentominoes
 {
-	std::mutex PentominoSolver::lock{};
+	// What findSolutionsAfterEdit() keeps between calls, for boards of one size and form of the puzzle
+	struct PentominoSolver::EditState
+	{
+		virtual ~EditState() = default;
+
+		int width{};
+		int height{};
+		bool minimizeRepeats{};
+		bool transposed{}; // Kept states are in the layout of the board as searched
+		std::string board{}; // Last board, and the cells of each of its solutions
+		std::vector<std::string> solutions{};
+	};
+
+	// The table is in the layout of the solver that filled it, so a board that needs another solver starts over
+	template <class Solver>
+	struct PentominoSolver::SolverEditState : EditState
+	{
+		explicit SolverEditState(std::size_t tableBytes)
+			: table(tableBytes)
+		{
+		}
+
+		TranspositionTable<Solver::cWords> table;
+	};
+
 	std::vector<PentominoSolver>* PentominoSolver::solutionsFound = new std::vector<PentominoSolver>;
 	std::chrono::duration<double> PentominoSolver::durationLastSolution{};
+	WideCount PentominoSolver::countLastSolution{};
+	Uniqueness PentominoSolver::uniquenessLastSolution{ Uniqueness::NoSolution };
+	PlacementKernel PentominoSolver::placementKernel{ PlacementKernel::Auto };
+	std::size_t PentominoSolver::transpositionTableBytes{ std::size_t{ 64 } << 20 };
+	TranspositionStats PentominoSolver::transpositionStatsLastSolution{};
+	std::unique_ptr<PentominoSolver::EditState> PentominoSolver::editState{};
+
+
+	void PentominoSolver::findAllSolutions(const PentominoBoard& board, bool minimizeRepeats, bool multithreading, SolveStrategy strategy)
+	{
+		using std::chrono::steady_clock;
+		solutionsFound->clear();
+		steady_clock::time_point begin(steady_clock::now());
+
+		if (strategy == SolveStrategy::CountTransferMatrix || strategy == SolveStrategy::CountMeetInTheMiddle
+			|| strategy == SolveStrategy::CountMemoized)
+		{
+			if (countSolutions(board, minimizeRepeats, strategy, multithreading))
+			{
+#if DEBUG_LEVEL > 0
+				if (strategy == SolveStrategy::CountMemoized)
+					transpositionStatsLastSolution.print();
+#endif
+				std::cout << "\nTotal solutions: " << countLastSolution.toString() << "\n";
+				steady_clock::time_point end(steady_clock::now());
+				durationLastSolution = std::chrono::duration_cast<std::chrono::duration<double >> (end - begin);
+				std::cout << "Time elapsed: " << durationLastSolution.count() << "\n";
+				return;
+			}
+			// Not applicable to this board, enumerate instead
+			std::cout << "Counting strategy doesn't apply to this board, falling back to backtracking.\n";
+		}
+
+		bool checkUniqueness{ strategy == SolveStrategy::CheckUniqueness };
+		if (checkUniqueness && dispatchBitBoard(board, minimizeRepeats, multithreading, true))
+		{
+			// solutionsFound holds the first solution of each distinct solution seen, at most 2
+			countLastSolution = solutionsFound->size();
+			uniquenessLastSolution = solutionsFound->empty() ? Uniqueness::NoSolution
+				: solutionsFound->size() == 1 ? Uniqueness::Unique : Uniqueness::Multiple;
+			std::cout << "\n" << (uniquenessLastSolution == Uniqueness::NoSolution ? "No solutions"
+				: uniquenessLastSolution == Uniqueness::Unique ? "Unique solution" : "Multiple solutions") << "\n";
+			steady_clock::time_point end(steady_clock::now());
+			durationLastSolution = std::chrono::duration_cast<std::chrono::duration<double >> (end - begin);
+			std::cout << "Time elapsed: " << durationLastSolution.count() << "\n";
+			return;
+		}
+
+		// Search on bitboards if the board fits in one of the instantiated sizes, otherwise scan the board string
+		if (!dispatchBitBoard(board, minimizeRepeats, multithreading, false))
+			searchStrings(board, minimizeRepeats, multithreading);
+		countLastSolution = solutionsFound->size();
+		std::cout << "\nTotal solutions: " << solutionsFound->size() << "\n";
+		if (checkUniqueness)
+		{
+			// Board too large for the bitboard search, so answer from the full enumeration
+			removeTrivialSolutions();
+			uniquenessLastSolution = solutionsFound->empty() ? Uniqueness::NoSolution
+				: solutionsFound->size() == 1 ? Uniqueness::Unique : Uniqueness::Multiple;
+		}
+		steady_clock::time_point end(steady_clock::now());
+		durationLastSolution = std::chrono::duration_cast<std::chrono::duration<double >> (end - begin);
+		std::cout << "Time elapsed: " << durationLastSolution.count() << "\n";
+
+	}
+
+	void PentominoSolver::findUniqueSolutions(const PentominoBoard& board, bool minimizeRepeats, bool multithreading, bool print)
+	{
+		using std::chrono::steady_clock;
+		solutionsFound->clear();
+		steady_clock::time_point begin(steady_clock::now());
+
+		int boardsPerRow{ std::max(ConsoleRenderer::get().getColumns() / (board.mWidth + 1), 1) };
+		size_t printed{ 0 };
+		auto printRow = [&]()
+		{
+			std::vector<const std::string*> boards{};
+			for (; printed < solutionsFound->size(); printed++)
+				boards.push_back(&(*solutionsFound)[printed].mBoard.mBoard);
+			ConsoleRenderer::get().printBoards(boards, board.mWidth, board.mHeight);
+		};
+
+		// The search threads are the producers, and a consumer keeps up with several of them.
+		// Producer i searches from orientation i, so merging them in order gives the single-threaded order.
+		int producers{ multithreading ? Pentomino::cTotalOrientations : 1 };
+		int consumers{ multithreading ? std::max(static_cast<int>(std::thread::hardware_concurrency()) / 4, 1) : 1 };
+		SolutionPipeline pipeline(board, producers, consumers,
+			[&](const std::vector<PlacedPentomino>& placements, const std::string& cells)
+		{
+			PentominoSolver solution(board, minimizeRepeats);
+			solution.mBoard.mBoard = cells;
+			solution.mPlacedPentominoes = placements;
+			solutionsFound->push_back(std::move(solution));
+			if (print && solutionsFound->size() - printed == static_cast<std::size_t>(boardsPerRow))
+				printRow();
+		}, true);
+
+		if (!dispatchBitBoard(board, minimizeRepeats, multithreading, false, &pipeline))
+		{
+			// Board too large for the bitboard search, so run the phases one after another
+			pipeline.join();
+			findAllSolutions(board, minimizeRepeats, multithreading);
+			removeTrivialSolutions();
+			if (print)
+				printSolutions();
+			return;
+		}
+		pipeline.join();
+		if (print)
+			printRow();
 
+		countLastSolution = pipeline.getSolutionCount();
+		std::cout << "\nTotal solutions: " << pipeline.getSolutionCount() << "\n";
+		std::cout << "Non-trivial solutions: " << pipeline.getUniqueCount() << "\n";
+		steady_clock::time_point end(steady_clock::now());
+		durationLastSolution = std::chrono::duration_cast<std::chrono::duration<double >> (end - begin);
+		std::cout << "Time elapsed: " << durationLastSolution.count() << "\n";
+	}
 
-	void PentominoSolver::findAllSolutions(const PentominoBoard& board, bool minimizeRepeats, bool multithreading)
+	bool PentominoSolver::sampleSolutions(const PentominoBoard& board, bool minimizeRepeats, int samples, uint64_t seed, bool multithreading)
 	{
 		using std::chrono::steady_clock;
 		solutionsFound->clear();
 		steady_clock::time_point begin(steady_clock::now());
 
-		PentominoSolver solver(board, minimizeRepeats);
-		//solutionsFound.reserve(board.mWidth * board.mHeight)
+		std::vector<std::string> cells{};
+		if (!dispatchSample(board, minimizeRepeats, samples, seed, multithreading, cells))
+		{
+			std::cout << "Board too large to sample\n";
+			return false;
+		}
+
+		for (const std::string& sample : cells)
+		{
+			if (sample.empty())
+				continue;
+			PentominoSolver solution(board, minimizeRepeats);
+			solution.mBoard.mBoard = sample;
+			solution.mBoard.reLetter();
+			solutionsFound->push_back(std::move(solution));
+		}
+
+		std::cout << "\nTotal solutions: " << countLastSolution.toString() << "\n";
+		std::cout << "Samples: " << solutionsFound->size() << "\n";
+		steady_clock::time_point end(steady_clock::now());
+		durationLastSolution = std::chrono::duration_cast<std::chrono::duration<double >> (end - begin);
+		std::cout << "Time elapsed: " << durationLastSolution.count() << "\n";
+		return true;
+	}
+
+	bool PentominoSolver::findStatistics(const PentominoBoard& board, bool minimizeRepeats, SolutionStatistics& statistics, bool multithreading)
+	{
+		using std::chrono::steady_clock;
+		steady_clock::time_point begin(steady_clock::now());
+
+		// Each search thread adds to its own copy, merged once every thread is done
+		statistics.mRepeatsFollowOrder = BitBoardSolver<1>::repeatsFollowOrder(board, minimizeRepeats);
+		SolutionStatistics empty{ statistics };
+		empty.clear();
+		std::vector<SolutionStatistics> perThread(multithreading ? Pentomino::cTotalOrientations : 1, empty);
+		if (!dispatchBitBoard(board, minimizeRepeats, multithreading, false, nullptr, &perThread))
+		{
+			std::cout << "Board too large for statistics\n";
+			return false;
+		}
+		for (const SolutionStatistics& own : perThread)
+			statistics.merge(own);
+
+		steady_clock::time_point end(steady_clock::now());
+		durationLastSolution = std::chrono::duration_cast<std::chrono::duration<double >> (end - begin);
+		std::cout << "Time elapsed: " << durationLastSolution.count() << "\n";
+		return true;
+	}
+
+	bool PentominoSolver::findSolutionsAfterEdit(const PentominoBoard& board, bool minimizeRepeats, bool multithreading)
+	{
+		using std::chrono::steady_clock;
+		solutionsFound->clear();
+		steady_clock::time_point begin(steady_clock::now());
+
+		if (!dispatchEdit(board, minimizeRepeats, multithreading))
+		{
+			std::cout << "Board too large to solve after an edit\n";
+			return false;
+		}
+
+		countLastSolution = solutionsFound->size();
+		std::cout << "\nTotal solutions: " << solutionsFound->size() << "\n";
+		steady_clock::time_point end(steady_clock::now());
+		durationLastSolution = std::chrono::duration_cast<std::chrono::duration<double >> (end - begin);
+		std::cout << "Time elapsed: " << durationLastSolution.count() << "\n";
+		return true;
+	}
+
+	void PentominoSolver::clearEditState()
+	{
+		editState.reset();
+	}
+
+	std::shared_ptr<SolveJob> PentominoSolver::solveAsync(const SolveRequest& request)
+	{
+		std::shared_ptr<SolveJob> job{ new SolveJob{ request.onSolutions, request.batchSize, request.ordered } };
+		if (!dispatchJob(request, job))
+			job->start(0, true);
+		return job;
+	}
+
+	bool PentominoSolver::setPlacementKernel(PlacementKernel kernel)
+	{
+		if (!isPlacementKernelSupported(kernel))
+			return false;
+		placementKernel = kernel;
+		return true;
+	}
+
+	// Adds every solution of the board to solutionsFound by scanning the board string, for boards too large for the
+	// bitboard search
+	void PentominoSolver::searchStrings(const PentominoBoard& board, bool minimizeRepeats, bool multithreading)
+	{
+		// One searcher per starting orientation when multithreading, each storing its solutions in its own arena.
+		// Reserved up front so the searchers never move while their threads run.
+		std::vector<PentominoSolver> searchers{};
+		searchers.reserve(multithreading ? Pentomino::cTotalOrientations : 1);
+		searchers.emplace_back(board, minimizeRepeats);
 		int startIndex{ static_cast<int>(board.mBoard.find('0')) };
 
 		std::vector<std::thread> threads{};
@@ -30,8 +281,8 @@ namespace Pentominoes
 		{
 
 			int orientations = Pentomino::getNumberOfOrientations(static_cast<OrientationBase>(base));
-			
 		
+	
 
 			for (int i = 0; i < orientations; i++)
 			{
@@ -40,141 +291,514 @@ namespace Pentominoes
 				int y = startIndex / board.mWidth;
 				if (multithreading)
 				{
-					if (minimizeRepeats && solver.checkPieceAvailable(startPiece))
-						threads.emplace_back(std::thread(&PentominoSolver::searchSimpleMinimizeRepeats, PentominoSolver(solver), startPiece, Point(x, y), 0));
-					else
-						threads.emplace_back(std::thread(&PentominoSolver::searchSimpleWithRepeats, PentominoSolver(solver), startPiece, Point(x, y), 0));
+					if (nextOrientation > 0)
+						searchers.emplace_back(board, minimizeRepeats);
+					PentominoSolver* searcher{ &searchers.back() };
+					bool useMinimize{ minimizeRepeats && searcher->checkPieceAvailable(startPiece) };
+					threads.emplace_back([searcher, startPiece, x, y, useMinimize]()
+					{
+						AllocationScope scope{ AllocationPhase::Search };
+						if (useMinimize)
+							searcher->searchSimpleMinimizeRepeats(startPiece, Point(x, y), 0);
+						else
+							searcher->searchSimpleWithRepeats(startPiece, Point(x, y), 0);
+					});
 				}
 				else
+				{
+					PentominoSolver& solver{ searchers[0] };
+					AllocationScope scope{ AllocationPhase::Search };
 					if (minimizeRepeats && solver.checkPieceAvailable(startPiece))
 						solver.searchSimpleMinimizeRepeats(startPiece, Point(x, y), 1);
 					else
 						solver.searchSimpleWithRepeats(startPiece, Point(x, y), 1);
+				}
 				nextOrientation++;
 			}
-			
+		
 		}
 
-		for (int i = 0; i < threads.size(); i++)
+		for (std::thread& thread : threads)
 		{
-			threads[i].join();
+			thread.join();
 		}
 		threads.clear();
-		std::cout << "\nTotal solutions: " << solutionsFound->size() << "\n";
-		steady_clock::time_point end(steady_clock::now());
-		durationLastSolution = std::chrono::duration_cast<std::chrono::duration<double >> (end - begin);
-		std::cout << "Time elapsed: " << durationLastSolution.count() << "\n";
 
+		for (const PentominoSolver& searcher : searchers)
+		{
+			for (int64_t i = 0; i < searcher.mSolutions.size(); i++)
+			{
+				PentominoSolver solution(board, minimizeRepeats);
+				solution.mBoard.mBoard.assign(searcher.mSolutions[i], searcher.mSolutions.getRecordSize());
+				solutionsFound->push_back(std::move(solution));
+			}
+		}
 	}
 
-	// Precondition: findAllSolutions() has been called
-	void PentominoSolver::removeTrivialSolutions()
+	// Pick the kernel specialized for the board's dimensions if there is one, otherwise the smallest
+	// generic kernel that fits. Returns false without searching if the board is too large for all of them.
+	// Precondition: the board has been trimmed
+	bool PentominoSolver::dispatchBitBoard(const PentominoBoard& board, bool minimizeRepeats, bool multithreading, bool checkUniqueness,
+		SolutionPipeline* pipeline, std::vector<SolutionStatistics>* statistics)
 	{
+#define PENTOMINO_DISPATCH_SPECIALIZED(width, height)\
+		if (searchBitBoard<BitBoardSolver<wordsForBoard(width, height), width, height>>(board, minimizeRepeats, multithreading, checkUniqueness, pipeline, statistics))\
+			return true;
+		PENTOMINO_SPECIALIZED_DIMENSIONS(PENTOMINO_DISPATCH_SPECIALIZED)
+#undef PENTOMINO_DISPATCH_SPECIALIZED
 
+		return searchBitBoard<BitBoardSolver<1>>(board, minimizeRepeats, multithreading, checkUniqueness, pipeline, statistics)
+			|| searchBitBoard<BitBoardSolver<2>>(board, minimizeRepeats, multithreading, checkUniqueness, pipeline, statistics)
+			|| searchBitBoard<BitBoardSolver<4>>(board, minimizeRepeats, multithreading, checkUniqueness, pipeline, statistics)
+			|| searchBitBoard<BitBoardSolver<8>>(board, minimizeRepeats, multithreading, checkUniqueness, pipeline, statistics);
+	}
 
-		if (solutionsFound->size() > 0)
+	bool PentominoSolver::countSolutions(const PentominoBoard& board, bool minimizeRepeats, SolveStrategy strategy, bool multithreading)
+	{
+		if (strategy == SolveStrategy::CountTransferMatrix)
+		{
+			TransferMatrixCounter counter(board);
+			if (minimizeRepeats || !counter.canCount())
+				return false;
+			countLastSolution = counter.count();
+			return true;
+		}
+		if (strategy == SolveStrategy::CountMeetInTheMiddle)
+		{
+			MeetInTheMiddleCounter counter(board, minimizeRepeats);
+			if (!counter.canCount())
+				return false;
+			countLastSolution = counter.count(multithreading);
+			return true;
+		}
+		if (strategy == SolveStrategy::CountMemoized)
+			return dispatchCount(board, minimizeRepeats, multithreading);
+		return false;
+	}
+
+	// Same choice of kernel as dispatchBitBoard()
+	bool PentominoSolver::dispatchCount(const PentominoBoard& board, bool minimizeRepeats, bool multithreading)
+	{
+#define PENTOMINO_DISPATCH_SPECIALIZED(width, height)\
+		if (countBitBoard<BitBoardSolver<wordsForBoard(width, height), width, height>>(board, minimizeRepeats, multithreading))\
+			return true;
+		PENTOMINO_SPECIALIZED_DIMENSIONS(PENTOMINO_DISPATCH_SPECIALIZED)
+#undef PENTOMINO_DISPATCH_SPECIALIZED
+
+		return countBitBoard<BitBoardSolver<1>>(board, minimizeRepeats, multithreading)
+			|| countBitBoard<BitBoardSolver<2>>(board, minimizeRepeats, multithreading)
+			|| countBitBoard<BitBoardSolver<4>>(board, minimizeRepeats, multithreading)
+			|| countBitBoard<BitBoardSolver<8>>(board, minimizeRepeats, multithreading);
+	}
+
+	// Same choice of kernel as dispatchBitBoard()
+	bool PentominoSolver::dispatchJob(const SolveRequest& request, const std::shared_ptr<SolveJob>& job)
+	{
+#define PENTOMINO_DISPATCH_SPECIALIZED(width, height)\
+		if (startJob<BitBoardSolver<wordsForBoard(width, height), width, height>>(request, job))\
+			return true;
+		PENTOMINO_SPECIALIZED_DIMENSIONS(PENTOMINO_DISPATCH_SPECIALIZED)
+#undef PENTOMINO_DISPATCH_SPECIALIZED
+
+		return startJob<BitBoardSolver<1>>(request, job)
+			|| startJob<BitBoardSolver<2>>(request, job)
+			|| startJob<BitBoardSolver<4>>(request, job)
+			|| startJob<BitBoardSolver<8>>(request, job);
+	}
+
+	// Returns false without starting anything if the board doesn't fit the solver.
+	// Submits a task per piece that fits the first open cell, each searching on its own copy of the solver
+	// and passing its solutions on in batches.
+	template <class Solver>
+	bool PentominoSolver::startJob(const SolveRequest& request, const std::shared_ptr<SolveJob>& job)
+	{
+		if (!Solver::fits(request.board, request.minimizeRepeats))
+			return false;
+
+		std::shared_ptr<const Solver> prototype{ std::make_shared<Solver>(request.board, request.minimizeRepeats, placementKernel) };
+		uint64_t orientations{ prototype->getFirstOrientations() };
+		job->start(popCount64(orientations));
+		// Tasks are numbered in the order searchAll() would reach them
+		for (int task = 0; orientations; task++)
 		{
-			PentominoBoard firstSolutionBoard = solutionsFound->at(0).mBoard;
-			int symmetry = firstSolutionBoard.mSymmetry;
-			int numBoardOrientations{ 0 };
-			bool isSquare = firstSolutionBoard.mWidth == firstSolutionBoard.mHeight;
+			PieceOrientation orientation{ static_cast<PieceOrientation>(countTrailingZeros64(orientations)) };
+			orientations &= orientations - 1;
+			ThreadPool::get().submit([job, prototype, orientation, task]()
+			{
+				if (!job->mCancelled)
+				{
+					Solver solver{ *prototype };
+					std::vector<std::vector<PlacedPentomino>> batch{};
+					solver.setStopFlag(&job->mCancelled);
+					solver.setNodeCounter(&job->mNodes);
+					solver.setSolutionCallback([&job, &batch, task](const std::vector<PlacedPentomino>& solution)
+					{
+						job->mSolutions.fetch_add(1, std::memory_order_relaxed);
+						if (job->mOnSolutions)
+						{
+							batch.push_back(solution);
+							if (static_cast<int>(batch.size()) == job->mBatchSize)
+							{
+								job->deliver(task, batch);
+								batch.clear();
+							}
+						}
+						return true;
+					});
+					solver.searchFrom(Pentomino(orientation));
+					job->deliver(task, batch);
+				}
+				job->finishTask(task);
+			});
+		}
+		return true;
+	}
+
+	// Returns false without counting if the board doesn't fit the solver
+	template <class Solver>
+	bool PentominoSolver::countBitBoard(const PentominoBoard& board, bool minimizeRepeats, bool multithreading)
+	{
+		if (!Solver::fits(board, minimizeRepeats))
+			return false;
+
+		TranspositionTable<Solver::cWords> table(transpositionTableBytes);
+		countLastSolution = countOrientations(Solver(board, minimizeRepeats, placementKernel), table, multithreading);
+		transpositionStatsLastSolution = table.getStats();
+		return true;
+	}
 
-			// Vector of vectors of function pointers. Each item corresponds with a transformation
-			// created by calling the sequence of PentominoBoard member functions.
-			std::vector<std::vector<PentominoBoard(PentominoBoard::*)() const>> transformFuncSequences
+	// Every solution of the prototype's board, counted from each first orientation on its own thread when multithreading.
+	// Every thread shares one table, so a state counted by one thread is reused by the others.
+	template <class Solver>
+	WideCount PentominoSolver::countOrientations(const Solver& prototype, TranspositionTable<Solver::cWords>& table, bool multithreading)
+	{
+		std::vector<Solver> solvers(multithreading ? Pentomino::cTotalOrientations : 1, prototype);
+		std::vector<WideCount> counts(Pentomino::cTotalOrientations);
+		if (multithreading)
+		{
+			std::vector<std::thread> threads{};
+			for (int i = 0; i < Pentomino::cTotalOrientations; i++)
 			{
-				std::vector<PentominoBoard(PentominoBoard::*)() const> {&PentominoBoard::getRotated90 },
-				std::vector<PentominoBoard(PentominoBoard::*)() const> {&PentominoBoard::getRotated180 },
-				std::vector<PentominoBoard(PentominoBoard::*)() const> {&PentominoBoard::getRotated180, &PentominoBoard::getRotated90 },
-				std::vector<PentominoBoard(PentominoBoard::*)() const> {&PentominoBoard::getHorizontalReflection },
-				std::vector<PentominoBoard(PentominoBoard::*)() const> {&PentominoBoard::getHorizontalReflection, &PentominoBoard::getRotated90 },
-				std::vector<PentominoBoard(PentominoBoard::*)() const> {&PentominoBoard::getHorizontalReflection, &PentominoBoard::getRotated180 },
-				std::vector<PentominoBoard(PentominoBoard::*)() const> {&PentominoBoard::getHorizontalReflection, &PentominoBoard::getRotated180,
-					&PentominoBoard::getRotated90}
-			};
-			// Array of bools will correspond with each sequence in transformFuncSequences
-			// These two structures will serve as a pattern to generate all the relevant
-			// transformations for this solution set.
-			bool uniqueTransformations[7]{};
-
-			if (!isSquare)
+				threads.emplace_back([&solvers, &counts, &table, i]()
+				{
+					counts[i] = solvers[i].countFrom(Pentomino(static_cast<PieceOrientation>(i)), table);
+				});
+			}
+			for (std::thread& thread : threads)
 			{
-				// Simple to define for non-square boards
-				if (symmetry & PentominoBoard::cMaskSymmetry180)
-					uniqueTransformations[1] = true;
-				if (symmetry & PentominoBoard::cMaskSymmetryHorizontal)
-					uniqueTransformations[3] = true;
-				if (symmetry & PentominoBoard::cMaskSymmetryVertical)
-					uniqueTransformations[5] = true;				
+				thread.join();
 			}
-			else
+		}
+		else
+		{
+			for (int i = 0; i < Pentomino::cTotalOrientations; i++)
+				counts[i] = solvers[0].countFrom(Pentomino(static_cast<PieceOrientation>(i)), table);
+		}
+
+		WideCount total{};
+		for (const WideCount& count : counts)
+			total += count;
+		return total;
+	}
+
+	// Same choice of kernel as dispatchBitBoard()
+	bool PentominoSolver::dispatchSample(const PentominoBoard& board, bool minimizeRepeats, int samples, uint64_t seed, bool multithreading,
+		std::vector<std::string>& cells)
+	{
+#define PENTOMINO_DISPATCH_SPECIALIZED(width, height)\
+		if (sampleBitBoard<BitBoardSolver<wordsForBoard(width, height), width, height>>(board, minimizeRepeats, samples, seed, multithreading, cells))\
+			return true;
+		PENTOMINO_SPECIALIZED_DIMENSIONS(PENTOMINO_DISPATCH_SPECIALIZED)
+#undef PENTOMINO_DISPATCH_SPECIALIZED
+
+		return sampleBitBoard<BitBoardSolver<1>>(board, minimizeRepeats, samples, seed, multithreading, cells)
+			|| sampleBitBoard<BitBoardSolver<2>>(board, minimizeRepeats, samples, seed, multithreading, cells)
+			|| sampleBitBoard<BitBoardSolver<4>>(board, minimizeRepeats, samples, seed, multithreading, cells)
+			|| sampleBitBoard<BitBoardSolver<8>>(board, minimizeRepeats, samples, seed, multithreading, cells);
+	}
+
+	// Returns false without sampling if the board doesn't fit the solver.
+	// The count fills the table first, then the threads take samples in turn, each drawing from a generator seeded
+	// by the sample's index. Cells of sample i are left in cells[i], empty if the board has no solution.
+	template <class Solver>
+	bool PentominoSolver::sampleBitBoard(const PentominoBoard& board, bool minimizeRepeats, int samples, uint64_t seed, bool multithreading,
+		std::vector<std::string>& cells)
+	{
+		if (!Solver::fits(board, minimizeRepeats))
+			return false;
+
+		TranspositionTable<Solver::cWords> table(transpositionTableBytes);
+		Solver prototype(board, minimizeRepeats, placementKernel);
+		countLastSolution = countOrientations(prototype, table, multithreading);
+
+		cells.assign(samples, std::string{});
+		std::atomic<int> nextSample{ 0 };
+		auto draw = [&]()
+		{
+			Solver solver{ prototype };
+			typename Solver::Solution solution{};
+			for (int i = nextSample++; i < samples; i = nextSample++)
 			{
-				// Less simple, so try each transformation and check if the board is still in the solution set
-				for (int i = 0; i < 7; i++)
+				std::mt19937_64 random{ seed ^ (static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ull) };
+				if (!solver.sample(table, random, solution))
+					continue;
+				cells[i] = board.mBoard;
+				for (const PlacedPentomino& placed : solution)
 				{
-					PentominoBoard transform{ firstSolutionBoard };
-					for (int j = 0; j < transformFuncSequences[i].size(); j++)
-					{
-						auto func = transformFuncSequences[i][j];
-						transform = (transform.*func)();
-					}
-					if (firstSolutionBoard.compareBoards(transform))
-						uniqueTransformations[i] = true;
-					
+					for (const PieceCell& cell : placed.pentomino.getCells())
+						cells[i][(placed.position.y + cell.y) * board.mWidth + placed.position.x + cell.x] = placed.symbol;
 				}
 			}
+		};
+		if (multithreading)
+		{
+			std::vector<std::thread> threads{};
+			for (unsigned i = 0; i < std::max(std::thread::hardware_concurrency(), 1u); i++)
+				threads.emplace_back(draw);
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+		}
+		else
+			draw();
+		transpositionStatsLastSolution = table.getStats();
+		return true;
+	}
 
-#if DEBUG_LEVEL > 0
-			bool printed{ false };
-#endif
+	// Same choice of kernel as dispatchBitBoard()
+	bool PentominoSolver::dispatchEdit(const PentominoBoard& board, bool minimizeRepeats, bool multithreading)
+	{
+#define PENTOMINO_DISPATCH_SPECIALIZED(width, height)\
+		if (searchAfterEdit<BitBoardSolver<wordsForBoard(width, height), width, height>>(board, minimizeRepeats, multithreading))\
+			return true;
+		PENTOMINO_SPECIALIZED_DIMENSIONS(PENTOMINO_DISPATCH_SPECIALIZED)
+#undef PENTOMINO_DISPATCH_SPECIALIZED
+
+		return searchAfterEdit<BitBoardSolver<1>>(board, minimizeRepeats, multithreading)
+			|| searchAfterEdit<BitBoardSolver<2>>(board, minimizeRepeats, multithreading)
+			|| searchAfterEdit<BitBoardSolver<4>>(board, minimizeRepeats, multithreading)
+			|| searchAfterEdit<BitBoardSolver<8>>(board, minimizeRepeats, multithreading);
+	}
+
+	// Returns false without searching if the board doesn't fit the solver
+	template <class Solver>
+	bool PentominoSolver::searchAfterEdit(const PentominoBoard& board, bool minimizeRepeats, bool multithreading)
+	{
+		if (!Solver::fits(board, minimizeRepeats))
+			return false;
+
+		// A no-repeat edit that takes the board past 12 pieces, or back under, also changes whether it's transposed
+		SolverEditState<Solver>* state{ dynamic_cast<SolverEditState<Solver>*>(editState.get()) };
+		bool transposed{ Solver::isTransposed(board, minimizeRepeats) };
+		if (!state || state->width != board.mWidth || state->height != board.mHeight || state->minimizeRepeats != minimizeRepeats
+			|| state->transposed != transposed)
+		{
+			editState = std::make_unique<SolverEditState<Solver>>(transpositionTableBytes);
+			state = static_cast<SolverEditState<Solver>*>(editState.get());
+			state->width = board.mWidth;
+			state->height = board.mHeight;
+			state->minimizeRepeats = minimizeRepeats;
+			state->transposed = transposed;
+		}
 
-			// Now iterate through the solutions, generate the transformations, and check against the remaining solutions.
-			for (int i = 0; i < solutionsFound->size() - 1; i++)
+		if (state->board == board.mBoard)
+		{
+			for (const std::string& cells : state->solutions)
+			{
+				PentominoSolver solution(board, minimizeRepeats);
+				solution.mBoard.mBoard = cells;
+				solutionsFound->push_back(std::move(solution));
+			}
+			return true;
+		}
+
+		std::vector<Solver> solvers(multithreading ? Pentomino::cTotalOrientations : 1,
+			Solver(board, minimizeRepeats, placementKernel));
+		if (multithreading)
+		{
+			std::vector<std::thread> threads{};
+			for (int i = 0; i < Pentomino::cTotalOrientations; i++)
 			{
-				// Generate the transformations
-				std::vector<PentominoBoard> transformations{};
-				for (int j = 0; j < 7; j++)
+				threads.emplace_back([&solvers, state, i]()
 				{
-					if (uniqueTransformations[j])
-					{
-						PentominoBoard transform{ solutionsFound->at(i).mBoard };
-						for (int k = 0; k < transformFuncSequences[j].size(); k++)
-						{
-							auto func = transformFuncSequences[j][k];
-							transform = (transform.*func)();
-						}
-						transform.reLetter();
-						transformations.push_back(transform);
-					}
-				}
+					solvers[i].searchFrom(Pentomino(static_cast<PieceOrientation>(i)), state->table);
+				});
+			}
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+		}
+		else
+		{
+			for (int i = 0; i < Pentomino::cTotalOrientations; i++)
+				solvers[0].searchFrom(Pentomino(static_cast<PieceOrientation>(i)), state->table);
+		}
 
-#if DEBUG_LEVEL > 0
-				if (!printed)
+		// Replay each solution onto a copy of the board, in order of the starting orientation
+		state->board = board.mBoard;
+		state->solutions.clear();
+		std::vector<PlacedPentomino> placements{};
+		for (const Solver& solver : solvers)
+		{
+			for (int64_t i = 0; i < solver.getSolutionCount(); i++)
+			{
+				solver.getSolution(i, placements);
+				PentominoSolver solution(board, minimizeRepeats);
+				for (const PlacedPentomino& placed : placements)
+					solution.tryPushPentomino(placed.pentomino, placed.position);
+				state->solutions.push_back(solution.mBoard.mBoard);
+				solutionsFound->push_back(std::move(solution));
+			}
+		}
+		transpositionStatsLastSolution = state->table.getStats();
+		return true;
+	}
+
+	// Returns false without searching if the board doesn't fit the solver.
+	// When checking uniqueness, only the first solution of each distinct solution is kept, and every
+	// solver stops as soon as a second distinct solution turns up.
+	// With a pipeline, solver i pushes its solutions to producer i of the pipeline instead of keeping them.
+	// With statistics, solver i adds its solutions to statistics[i] instead of keeping them.
+	// Precondition: the pipeline has a producer per solver, and there are statistics for each solver,
+	// Pentomino::cTotalOrientations when multithreading
+	template <class Solver>
+	bool PentominoSolver::searchBitBoard(const PentominoBoard& board, bool minimizeRepeats, bool multithreading, bool checkUniqueness,
+		SolutionPipeline* pipeline, std::vector<SolutionStatistics>* statistics)
+	{
+		if (!Solver::fits(board, minimizeRepeats))
+			return false;
+
+		// One solver per starting orientation when multithreading, so each thread has its own state and results
+		std::vector<Solver> solvers(multithreading ? Pentomino::cTotalOrientations : 1,
+			Solver(board, minimizeRepeats, placementKernel));
+
+		std::atomic<bool> stop{ false };
+		std::mutex distinctLock{};
+		std::vector<std::string> distinctKeys{};
+		std::vector<std::vector<PlacedPentomino>> distinctSolutions{};
+		SolutionCanonicalizer canonicalizer{ board };
+		if (checkUniqueness)
+		{
+			for (Solver& solver : solvers)
+			{
+				solver.setStopFlag(&stop);
+				solver.setSolutionCallback([&](const std::vector<PlacedPentomino>& solution)
 				{
-					std::cout << "Unique transformations of solutionsFound[0]:\n";
-					for (int j = 0; j < transformations.size(); j++)
+					std::string key{ canonicalizer.getKey(solution) };
+					std::lock_guard<std::mutex> guard{ distinctLock };
+					if (distinctKeys.size() < 2 && std::find(distinctKeys.begin(), distinctKeys.end(), key) == distinctKeys.end())
 					{
-						transformations[j].printBoard();
+						distinctKeys.push_back(std::move(key));
+						distinctSolutions.push_back(solution);
+						if (distinctKeys.size() == 2)
+							stop = true;
 					}
-					printed = true;
-				}
-#endif
+					return !stop;
+				});
+			}
+		}
+		else if (pipeline)
+		{
+			for (int i = 0; i < static_cast<int>(solvers.size()); i++)
+			{
+				solvers[i].setSolutionCallback([pipeline, i](const std::vector<PlacedPentomino>& solution)
+				{
+					pipeline->push(i, solution);
+					return true;
+				});
+			}
+		}
+		else if (statistics)
+		{
+			for (int i = 0; i < static_cast<int>(solvers.size()); i++)
+			{
+				SolutionStatistics* own{ &(*statistics)[i] };
+				solvers[i].setSolutionCallback([own](const std::vector<PlacedPentomino>& solution)
+				{
+					own->add(solution);
+					return true;
+				});
+			}
+		}
 
-				for (int j = i + 1; j < solutionsFound->size(); j++)
+		if (multithreading)
+		{
+			std::vector<std::thread> threads{};
+			for (int i = 0; i < Pentomino::cTotalOrientations; i++)
+			{
+				threads.emplace_back([&solvers, pipeline, i]()
 				{
-					for (int k = 0; k < transformations.size(); k++)
-					{
-						if (solutionsFound->at(j).mBoard.mBoard.compare(transformations[k].mBoard) == 0)
-						{
-							// Match found, remove from solutions
-							solutionsFound->erase(solutionsFound->begin() + j);
-							j--;
-							break;
-						}
-					}
-				}
+					solvers[i].searchFrom(Pentomino(static_cast<PieceOrientation>(i)));
+					if (pipeline)
+						pipeline->close(i);
+				});
+			}
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+		}
+		else
+		{
+			solvers[0].searchAll();
+			if (pipeline)
+				pipeline->close(0);
+		}
 
+		// Replay each solution onto a copy of the board, in order of the starting orientation
+		auto replay = [&](const std::vector<PlacedPentomino>& placements)
+		{
+			PentominoSolver solution(board, minimizeRepeats);
+			for (const PlacedPentomino& placed : placements)
+				solution.tryPushPentomino(placed.pentomino, placed.position);
+			solutionsFound->push_back(std::move(solution));
+		};
+		for (const std::vector<PlacedPentomino>& placements : distinctSolutions)
+			replay(placements);
+		std::vector<PlacedPentomino> placements{};
+		for (const Solver& solver : solvers)
+		{
+			for (int64_t i = 0; i < solver.getSolutionCount(); i++)
+			{
+				solver.getSolution(i, placements);
+				replay(placements);
 			}
+		}
+		return true;
+	}
+
+	// Precondition: findAllSolutions() has been called
+	// Keeps the first solution of each set of solutions that are transformations of each other.
+	// Keying every solution by its canonical form transforms each solution once instead of
+	// comparing it with every other.
+	void PentominoSolver::removeTrivialSolutions()
+	{
+		if (solutionsFound->size() > 0)
+		{
+			const PentominoBoard& firstSolutionBoard{ solutionsFound->at(0).mBoard };
+			SolutionCanonicalizer canonicalizer{ firstSolutionBoard };
+
+#if DEBUG_LEVEL > 0
+			std::cout << "Unique transformations of solutionsFound[0]:\n";
+			for (const CellTransform& symmetry : canonicalizer.getSymmetries())
+			{
+				PentominoBoard transform{ firstSolutionBoard };
+				symmetry.apply(firstSolutionBoard.mBoard.data(), &transform.mBoard[0]);
+				transform.reLetter();
+				transform.printBoard();
+			}
+#endif
+
+			std::unordered_set<std::string> seen{};
+			std::vector<PentominoSolver> uniqueSolutions{};
+			for (PentominoSolver& solution : *solutionsFound)
+			{
+				if (seen.insert(canonicalizer.getKey(solution.mBoard.mBoard)).second)
+					uniqueSolutions.push_back(std::move(solution));
+			}
+			*solutionsFound = std::move(uniqueSolutions);
 
 #if DEBUG_LEVEL > 0
 			std::cout << "Number of non-trivial solutions: " << solutionsFound->size() << "\n";
@@ -187,43 +811,31 @@ namespace Pentominoes
 	{
 		if (solutionsFound->size() > 0)
 		{
-			CONSOLE_SCREEN_BUFFER_INFO csbi;
-			GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi);
-			int consoleColumns{ csbi.srWindow.Right - csbi.srWindow.Left + 1 };
-
-			int height{ solutionsFound->at(0).mBoard.mHeight };
-			int width{ solutionsFound->at(0).mBoard.mWidth };
-			int solutionsPerRow{ consoleColumns / (width + 1) };
-			
-			// Iterate through all solutions in batches of size solutionsPerRow
-			for (int i = 0; i < solutionsFound->size(); i+= solutionsPerRow)
-			{
-				// If last row, only access remaining solutions
-				int solutionsThisRow = (i + solutionsPerRow > solutionsFound->size())? solutionsFound->size() % solutionsPerRow : solutionsPerRow;
-
-				// Print each batch line height times
-				for (int j = 0; j < height; j++)
-				{
-					// Iterate through the batch
-					for (int k = 0; k < solutionsThisRow; k++)
-					{
-						solutionsFound->at(i + k).mBoard.printLine(j);
-						std::cout << " ";
-					}
-				
-				std::cout << "\n";
-				}
-				
-				std::cout << "\n";
-			}
+			std::vector<const std::string*> boards{};
+			boards.reserve(solutionsFound->size());
+			for (const PentominoSolver& solution : *solutionsFound)
+				boards.push_back(&solution.mBoard.mBoard);
+			ConsoleRenderer::get().printBoards(boards, solutionsFound->at(0).mBoard.mWidth, solutionsFound->at(0).mBoard.mHeight);
 		}
 		
 	}
 
+	SolutionIndex PentominoSolver::indexSolutions()
+	{
+		if (solutionsFound->empty())
+			return SolutionIndex{ 0, 0 };
+		SolutionIndex index{ solutionsFound->at(0).mBoard.mWidth, solutionsFound->at(0).mBoard.mHeight };
+		for (const PentominoSolver& solution : *solutionsFound)
+			index.addSolvedBoard(solution.mBoard.mBoard);
+		return index;
+	}
+
 
 	PentominoSolver::PentominoSolver(const PentominoBoard& board, bool minimizeRepeats) 
-		: mBoard{ board }, mMinimizeRepeats{ minimizeRepeats }, mPiecesAvailable{ nullptr }
+		: mBoard{ board }, mMinimizeRepeats{ minimizeRepeats }, mPiecesAvailable{ nullptr },
+		mSolutions{ static_cast<int>(board.mBoard.size()) }
 	{
+		mPlacedPentominoes.reserve(std::count(board.mBoard.begin(), board.mBoard.end(), '0') / 5);
 		if (mMinimizeRepeats)
 		{
 			mPiecesAvailable = new bool[Pentomino::cTotalBasePieces];
@@ -232,7 +844,7 @@ namespace Pentominoes
 	}
 
 	PentominoSolver::PentominoSolver(const PentominoSolver& original)
-		: mBoard{ original.mBoard }, mMinimizeRepeats{ original.mMinimizeRepeats }
+		: mBoard{ original.mBoard }, mMinimizeRepeats{ original.mMinimizeRepeats }, mSolutions{ original.mSolutions }
 	{
 #if DEBUG_LEVEL > 1
 		std::cout << "copy\n";
@@ -252,7 +864,7 @@ namespace Pentominoes
 
 	PentominoSolver::PentominoSolver(PentominoSolver&& original) noexcept
 		: mBoard{ original.mBoard }, mMinimizeRepeats{ original.mMinimizeRepeats }, mPiecesAvailable{ original.mPiecesAvailable },
-		mPlacedPentominoes{ original.mPlacedPentominoes }, mNextSymbol{ original.mNextSymbol }
+		mPlacedPentominoes{ original.mPlacedPentominoes }, mNextSymbol{ original.mNextSymbol }, mSolutions{ std::move(original.mSolutions) }
 	{
 #if DEBUG_LEVEL > 1
 		std::cout << "move\n";
@@ -299,6 +911,7 @@ namespace Pentominoes
 		mNextSymbol = original.mNextSymbol;
 		mPlacedPentominoes = original.mPlacedPentominoes;
 		mPiecesAvailable = original.mPiecesAvailable;
+		mSolutions = std::move(original.mSolutions);
 		
 		// Nullify dangling pointer
 		original.mPiecesAvailable = nullptr;
@@ -323,48 +936,29 @@ namespace Pentominoes
 		{
 			
 			// Check if the piece overlaps with anything on the board
-			std::string pieceStr = piece.getDataString();
-			Pentomino::removeNewLines(pieceStr);
-
-			std::string boardStringCopy = mBoard.mBoard;
-			for (int i = 0; i < piece.getRectangleHeight(); i++)
+			int anchorIndex = pos.x + pos.y * mBoard.mWidth;
+			for (const PieceCell& cell : piece.getCells())
 			{
-				for (int j = 0; j < piece.getRectangleWidth(); j++)
+				if (mBoard[anchorIndex + cell.y * mBoard.mWidth + cell.x] != '0')
 				{
-					int piecePosIndex = piece.getRectangleWidth() * i + j;
-					int boardPosIndex = pos.x + pos.y * mBoard.mWidth +
-						i * mBoard.mWidth + j;
-
-					if (pieceStr[piecePosIndex] == '1')
-					{
-						if (mBoard[boardPosIndex] != '0')
-						{
 #if DEBUG_LEVEL > 1
-							std::cout << "Failed to place piece " + piece.getLabelString() << " at (" << pos.x << ", " << pos.y << ")\n";
+					std::cout << "Failed to place piece " << piece.getLabelString() << " at (" << pos.x << ", " << pos.y << ")\n";
 #endif
-							return false;
-						}
-						else
-						{
-							// 'place' the cell on the copy board
-							boardStringCopy[boardPosIndex] = mNextSymbol;
-						}
-					}
+					return false;
 				}
 			}
 
-			// Piece fits, push it
+			// Piece fits, place it on the board and push it
+			for (const PieceCell& cell : piece.getCells())
+				mBoard[anchorIndex + cell.y * mBoard.mWidth + cell.x] = mNextSymbol;
 			mPlacedPentominoes.push_back(PlacedPentomino{ piece, pos, mNextSymbol++ });
 
-			// Update the board to the copy
-			mBoard.mBoard = boardStringCopy;
-
 			// If minimizing repeats, mark this piece orientation as unavailable
 			if (mMinimizeRepeats)
 				setAvailable(piece, false);
 
 #if DEBUG_LEVEL > 1
-			std::cout << "Successfully placed piece " + piece.getLabelString() << " at (" << pos.x << ", " << pos.y << ")\n";
+			std::cout << "Successfully placed piece " << piece.getLabelString() << " at (" << pos.x << ", " << pos.y << ")\n";
 			std::cout << "New board:\n";
 			mBoard.printBoard();
 #endif
@@ -373,7 +967,7 @@ namespace Pentominoes
 		else
 		{
 #if DEBUG_LEVEL > 1
-			std::cout << "Failed to place piece " + piece.getLabelString() << " at (" << pos.x << ", " << pos.y << ")\n";
+			std::cout << "Failed to place piece " << piece.getLabelString() << " at (" << pos.x << ", " << pos.y << ")\n";
 #endif
 			return false;
 		}
@@ -415,9 +1009,7 @@ namespace Pentominoes
 			{
 
 				// Board is solved, add the solution
-				lock.lock();
-				solutionsFound->emplace_back(*this);
-				lock.unlock();
+				storeSolution();
 #if DEBUG_LEVEL > 1
 				std::cout << "Solution found!\n";
 #endif
@@ -427,8 +1019,10 @@ namespace Pentominoes
 			}
 			else if (isPossibleSolution())
 			{
-				// Next branches consist of all available fitting pieces in the next available spot		
-				if (checkNoPiecesAvailable())
+				// Next branches consist of all available fitting pieces in the next available spot.
+				// Once every piece has been used, each may be used once more.
+				bool newRound{ checkNoPiecesAvailable() };
+				if (newRound)
 					resetAvailable();
 
 				for (int i = 0; i < Pentomino::cTotalOrientations; i++)
@@ -442,6 +1036,12 @@ namespace Pentominoes
 						searchSimpleMinimizeRepeats(nextPiece, nextPos, depth + 1);
 					}
 				}
+				// Backtracking to the previous round, where every piece was already used
+				if (newRound)
+				{
+					for (int i = 0; i < Pentomino::cTotalBasePieces; i++)
+						mPiecesAvailable[i] = false;
+				}
 	
 				// All branches at this level explored, backtrack
 #if DEBUG_LEVEL > 1
@@ -474,9 +1074,7 @@ namespace Pentominoes
 			{
 
 				// Board is solved, add the solution
-				lock.lock();
-				solutionsFound->emplace_back(*this);
-				lock.unlock();
+				storeSolution();
 #if DEBUG_LEVEL > 1
 				std::cout << "Solution found!\n";
 #endif
@@ -554,32 +1152,25 @@ namespace Pentominoes
 
 	bool PentominoSolver::isPossibleSolution()
 	{
-		std::vector<int> areas(findHoleAreas());
-
-		for (int area : areas)
-		{
-			if (area % 5 != 0)
-				return false;
-		}
-		return true;
-	}
-
-	std::vector<int> PentominoSolver::findHoleAreas()
-	{
-		std::vector<int> areas;
-		for (int i = 0; i < mBoard.mHeight; i++)
+		// Measure each hole in turn, marking its cells so it's only measured once
+		bool possible{ true };
+		for (int i = 0; i < mBoard.mWidth * mBoard.mHeight && possible; i++)
 		{
-			for (int j = 0; j < mBoard.mWidth; j++)
-			{
-				if (mBoard[i * mBoard.mWidth + j] == '0')
-					areas.push_back(findHoleArea(Point(j, i)));
-			}
+			if (mBoard[i] == '0' && findHoleArea(Point(i % mBoard.mWidth, i / mBoard.mWidth)) % 5 != 0)
+				possible = false;
 		}
 
 		// Unmark the holes on the board
 		mBoard.replaceChars('m', '0');
 			
-		return areas;
+		return possible;
+	}
+
+	// Copy the solved board into this searcher's arena, findAllSolutions() collects them after the search
+	void PentominoSolver::storeSolution()
+	{
+		AllocationScope scope{ AllocationPhase::SolutionStorage };
+		std::copy(mBoard.mBoard.begin(), mBoard.mBoard.end(), mSolutions.allocate());
 	}
 
 	// Recursive function to sum all the adjacent holes in a given hole on the board.
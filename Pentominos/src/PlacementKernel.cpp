@@ -0,0 +1,168 @@
+#include "PlacementKernel.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PENTOMINO_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions that ask for them
+#if defined(PENTOMINO_X86) && !defined(_MSC_VER)
+#define PENTOMINO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PENTOMINO_TARGET_AVX2
+#endif
+
+namespace Pentominoes
+{
+	namespace
+	{
+		uint64_t lowBits(int count)
+		{
+			return count >= 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << count) - 1;
+		}
+
+		uint64_t fitTestScalar(const uint64_t* masks, int stride, int count, int words, const uint64_t* open)
+		{
+			uint64_t fitting{ 0 };
+			for (int i = 0; i < count; i++)
+			{
+				uint64_t blocked{ 0 };
+				for (int w = 0; w < words; w++)
+					blocked |= masks[w * stride + i] & ~open[w];
+				if (!blocked)
+					fitting |= uint64_t{ 1 } << i;
+			}
+			return fitting;
+		}
+
+#ifdef PENTOMINO_X86
+		uint64_t fitTestSSE2(const uint64_t* masks, int stride, int count, int words, const uint64_t* open)
+		{
+			uint64_t fitting{ 0 };
+			const __m128i zero{ _mm_setzero_si128() };
+			for (int i = 0; i < count; i += 2)
+			{
+				__m128i blocked{ zero };
+				for (int w = 0; w < words; w++)
+				{
+					__m128i mask{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + w * stride + i)) };
+					blocked = _mm_or_si128(blocked, _mm_andnot_si128(_mm_set1_epi64x(static_cast<long long>(open[w])), mask));
+				}
+				// SSE2 has no 64 bit compare, so a lane is zero if both of its 32 bit halves are
+				__m128i halves{ _mm_cmpeq_epi32(blocked, zero) };
+				__m128i lanes{ _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1))) };
+				fitting |= static_cast<uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(lanes))) << i;
+			}
+			return fitting & lowBits(count);
+		}
+
+		PENTOMINO_TARGET_AVX2
+		uint64_t fitTestAVX2(const uint64_t* masks, int stride, int count, int words, const uint64_t* open)
+		{
+			uint64_t fitting{ 0 };
+			const __m256i zero{ _mm256_setzero_si256() };
+			for (int i = 0; i < count; i += 4)
+			{
+				__m256i blocked{ zero };
+				for (int w = 0; w < words; w++)
+				{
+					__m256i mask{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + w * stride + i)) };
+					blocked = _mm256_or_si256(blocked, _mm256_andnot_si256(_mm256_set1_epi64x(static_cast<long long>(open[w])), mask));
+				}
+				__m256i lanes{ _mm256_cmpeq_epi64(blocked, zero) };
+				fitting |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(lanes))) << i;
+			}
+			return fitting & lowBits(count);
+		}
+
+		bool cpuHasAVX2()
+		{
+#if defined(_MSC_VER)
+			int info[4]{};
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return false;
+			// The OS has to save the AVX registers on context switches too
+			__cpuid(info, 1);
+			bool osSavesAVX{ (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6 };
+			__cpuidex(info, 7, 0);
+			return osSavesAVX && (info[1] & (1 << 5));
+#else
+			return __builtin_cpu_supports("avx2");
+#endif
+		}
+#endif
+	}
+
+	bool isPlacementKernelSupported(PlacementKernel kernel)
+	{
+		switch (kernel)
+		{
+		case PlacementKernel::Auto:
+		case PlacementKernel::Scalar:
+		case PlacementKernel::Neighborhood:
+			return true;
+#ifdef PENTOMINO_X86
+		case PlacementKernel::SSE2:
+			return true; // Part of every x86-64 CPU
+		case PlacementKernel::AVX2:
+		{
+			static const bool hasAVX2{ cpuHasAVX2() };
+			return hasAVX2;
+		}
+#endif
+		default:
+			return false;
+		}
+	}
+
+	PlacementKernel resolvePlacementKernel(PlacementKernel kernel)
+	{
+		if (kernel != PlacementKernel::Auto)
+			return kernel;
+		if (isPlacementKernelSupported(PlacementKernel::AVX2))
+			return PlacementKernel::AVX2;
+		if (isPlacementKernelSupported(PlacementKernel::SSE2))
+			return PlacementKernel::SSE2;
+		return PlacementKernel::Scalar;
+	}
+
+	FitTest getFitTest(PlacementKernel kernel)
+	{
+		switch (resolvePlacementKernel(kernel))
+		{
+#ifdef PENTOMINO_X86
+		case PlacementKernel::SSE2:
+			return &fitTestSSE2;
+		case PlacementKernel::AVX2:
+			return &fitTestAVX2;
+#endif
+		case PlacementKernel::Neighborhood:
+			return nullptr;
+		default:
+			return &fitTestScalar;
+		}
+	}
+
+	const char* getPlacementKernelName(PlacementKernel kernel)
+	{
+		switch (kernel)
+		{
+		case PlacementKernel::Auto:
+			return "Auto";
+		case PlacementKernel::Scalar:
+			return "Scalar";
+		case PlacementKernel::SSE2:
+			return "SSE2";
+		case PlacementKernel::AVX2:
+			return "AVX2";
+		case PlacementKernel::Neighborhood:
+			return "Neighborhood";
+		default:
+			return "Unknown";
+		}
+	}
+}
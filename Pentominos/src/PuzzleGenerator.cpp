@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "PuzzleGenerator.h"
+#include "BitBoardSolver.h"
+#include "BoardParser.h"
+#include "SolutionCanonicalizer.h"
+
+namespace Pentominoes
+{
+	void GeneratorStats::print() const
+	{
+		std::cout << "Sampled: " << sampled << "\n";
+		std::cout << "Rejected, area not a multiple of 5: " << rejectedArea << "\n";
+		std::cout << "Rejected, island not a multiple of 5: " << rejectedIslands << "\n";
+		std::cout << "Rejected, uncoverable cell: " << rejectedDeadCells << "\n";
+		std::cout << "Solved: " << solved << "\n";
+		std::cout << "No solution: " << noSolution << "\n";
+		std::cout << "Multiple solutions: " << multipleSolutions << "\n";
+		std::cout << "Unique solution: " << unique << "\n";
+	}
+
+	bool PuzzleGenerator::run(const PuzzleCallback& onPuzzle)
+	{
+		if (mOptions.width <= 0 || mOptions.height <= 0 || (mOptions.width + 1) * mOptions.height > BitBoard<8>::cBits)
+			return false;
+
+		mNextSample = 0;
+		for (std::atomic<int64_t>& counter : mCounters)
+			counter = 0;
+
+		int threadCount{ mOptions.threads > 0 ? mOptions.threads : static_cast<int>(std::thread::hardware_concurrency()) };
+		threadCount = std::max(threadCount, 1);
+		std::mutex outputLock{};
+		std::vector<std::thread> threads{};
+		for (int i = 0; i < threadCount; i++)
+		{
+			threads.emplace_back([this, &onPuzzle, &outputLock]()
+			{
+				// Trimming only shrinks a board, so the box decides how many words every sample needs
+				switch (wordsForBoard(mOptions.width, mOptions.height))
+				{
+				case 1:
+					work<1>(onPuzzle, outputLock);
+					break;
+				case 2:
+					work<2>(onPuzzle, outputLock);
+					break;
+				case 4:
+					work<4>(onPuzzle, outputLock);
+					break;
+				default:
+					work<8>(onPuzzle, outputLock);
+					break;
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		return true;
+	}
+
+	GeneratorStats PuzzleGenerator::getStats() const
+	{
+		auto get = [this](Stage stage) { return mCounters[static_cast<int>(stage)].load(std::memory_order_relaxed); };
+		GeneratorStats stats{};
+		stats.sampled = get(Stage::Sampled);
+		stats.rejectedArea = get(Stage::RejectedArea);
+		stats.rejectedIslands = get(Stage::RejectedIslands);
+		stats.rejectedDeadCells = get(Stage::RejectedDeadCells);
+		stats.solved = get(Stage::Solved);
+		stats.noSolution = get(Stage::NoSolution);
+		stats.multipleSolutions = get(Stage::MultipleSolutions);
+		stats.unique = get(Stage::Unique);
+		return stats;
+	}
+
+	// Board text for one sample, in the input format
+	std::string PuzzleGenerator::sampleBoard(int64_t sample) const
+	{
+		std::mt19937_64 rng{ mOptions.seed ^ (static_cast<uint64_t>(sample) * 0x9E3779B97F4A7C15ull) };
+		std::bernoulli_distribution isWall{ mOptions.wallProbability };
+		std::string text{};
+		text.reserve(static_cast<size_t>(mOptions.width + 1) * mOptions.height);
+		for (int row = 0; row < mOptions.height; row++)
+		{
+			for (int col = 0; col < mOptions.width; col++)
+				text += isWall(rng) ? '1' : '0';
+			text += '\n';
+		}
+		return text;
+	}
+
+	template <int Words>
+	void PuzzleGenerator::work(const PuzzleCallback& onPuzzle, std::mutex& outputLock)
+	{
+		for (int64_t sample = mNextSample++; sample < mOptions.samples; sample = mNextSample++)
+		{
+			count(Stage::Sampled);
+			std::string text{ sampleBoard(sample) };
+			int64_t holes{ std::count(text.begin(), text.end(), '0') };
+			if (holes == 0 || holes % 5 != 0)
+			{
+				count(Stage::RejectedArea);
+				continue;
+			}
+
+			PentominoBoard board{};
+			BoardParser parser{ text.data(), text.size() };
+			parser.next(board);
+			BitBoardSolver<Words> solver{ board, mOptions.minimizeRepeats };
+			if (!solver.isPossibleSolution())
+			{
+				count(Stage::RejectedIslands);
+				continue;
+			}
+			if (!solver.getOpenCells().isSubsetOf(solver.getCoverage()))
+			{
+				count(Stage::RejectedDeadCells);
+				continue;
+			}
+
+			// Stop at the first solution that isn't a symmetry of the first one found
+			count(Stage::Solved);
+			SolutionCanonicalizer canonicalizer{ board };
+			std::string firstKey{};
+			std::vector<PlacedPentomino> firstSolution{};
+			bool multiple{ false };
+			solver.setSolutionCallback([&](const std::vector<PlacedPentomino>& solution)
+			{
+				std::string key{ canonicalizer.getKey(solution) };
+				if (firstSolution.empty())
+				{
+					firstKey = std::move(key);
+					firstSolution = solution;
+					return true;
+				}
+				multiple = key != firstKey;
+				return !multiple;
+			});
+			solver.searchAll();
+
+			if (firstSolution.empty())
+			{
+				count(Stage::NoSolution);
+			}
+			else if (multiple)
+			{
+				count(Stage::MultipleSolutions);
+			}
+			else
+			{
+				count(Stage::Unique);
+				std::lock_guard<std::mutex> guard{ outputLock };
+				onPuzzle(board, firstSolution);
+			}
+		}
+	}
+}
@@ -0,0 +1,511 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "SelfCheck.h"
+#include "BoardTransform.h"
+#include "MeetInTheMiddleCounter.h"
+#include "PentominoSolver.h"
+#include "SolutionCanonicalizer.h"
+#include "SolutionPipeline.h"
+#include "SolutionStatistics.h"
+#include "SolveJob.h"
+
+namespace Pentominoes
+{
+	namespace
+	{
+		// Sends std::cout nowhere while it's alive
+		class QuietScope
+		{
+		public:
+			QuietScope()
+				: mOriginal{ std::cout.rdbuf(mSink.rdbuf()) }
+			{
+			}
+			QuietScope(const QuietScope&) = delete;
+			QuietScope& operator=(const QuietScope&) = delete;
+			~QuietScope() { std::cout.rdbuf(mOriginal); }
+
+		private:
+			std::ostringstream mSink{};
+			std::streambuf* mOriginal{};
+		};
+
+		// Two rooms of 35 cells, one above the other, so the board needs 14 pieces and two of them repeat
+		const std::initializer_list<const char*> cStackedRooms{
+			"0000000",
+			"0000000",
+			"0000000",
+			"0000000",
+			"0000000",
+			"1111111",
+			"0000000",
+			"0000000",
+			"0000000",
+			"0000000",
+			"0000000" };
+		// Rooms of 35 and 30 cells side by side, which the bitboard search would rather search transposed
+		const std::initializer_list<const char*> cSideBySideRooms{
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"00000111111" };
+		// The same rooms the other way round
+		const std::initializer_list<const char*> cSwappedRooms{
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"11111100000" };
+		// Two rooms of 30 cells, 12 pieces, so this one is searched transposed
+		const std::initializer_list<const char*> cShiftedRooms{
+			"00000111111",
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"00000100000",
+			"11111100000" };
+		// A 3x15 room above a 3x10 room, 15 pieces with only 8 solutions between them
+		const std::initializer_list<const char*> cStackedStrips{
+			"000", "000", "000", "000", "000", "000", "000", "000", "000", "000", "000", "000", "000", "000", "000",
+			"111",
+			"000", "000", "000", "000", "000", "000", "000", "000", "000", "000" };
+	}
+
+	bool SelfCheck::runAll()
+	{
+		bool passed{ true };
+		passed &= checkMemoizedCount(cStackedRooms, "70 cells");
+		passed &= checkMemoizedCount(cSideBySideRooms, "65 cells wide");
+		passed &= checkCounter({ "000000", "000000", "000000", "000000", "000000" }, false, SolveStrategy::CountTransferMatrix,
+			"TransferMatrix matches Backtrack with repeats, 30 cells");
+		passed &= checkCounter({ "000000", "000000", "001000", "000000", "000000", "000000" }, false,
+			SolveStrategy::CountTransferMatrix, "TransferMatrix matches Backtrack with repeats, 35 cells around a wall");
+		passed &= checkCounter({ "000000", "000000", "000000", "000000", "000000" }, false, SolveStrategy::CountMeetInTheMiddle,
+			"MeetInTheMiddle matches Backtrack with repeats, 30 cells");
+		passed &= checkCounter({ "0000000000", "0000000000", "0000000000", "0000000000", "0000000000", "0000000000" }, true,
+			SolveStrategy::CountMeetInTheMiddle, "MeetInTheMiddle matches Backtrack without repeats, 60 cells");
+		passed &= checkCounter(cShiftedRooms, true, SolveStrategy::CountMeetInTheMiddle,
+			"MeetInTheMiddle matches Backtrack without repeats, 60 cells around walls");
+		passed &= checkMeetInTheMiddleRefuses();
+		passed &= checkStatistics({ "000000", "000000", "000000", "000000", "000000" }, "30 cells");
+		passed &= checkStatistics({ "00000", "00000", "00000", "00000", "00000", "00000", "00000", "00000", "00000", "00000",
+			"00000", "00000", "00000" }, "65 cells");
+		passed &= checkKernels();
+		passed &= checkTransforms<1>(7);
+		passed &= checkTransforms<2>(10);
+		passed &= checkTransforms<4>(15);
+		passed &= checkTransforms<8>(21);
+		passed &= checkSearchOrder();
+		passed &= checkEdits();
+		passed &= checkSampling();
+		passed &= checkCancel();
+		passed &= checkHeldSolutions();
+		passed &= checkHeldBatches();
+		std::cout << (passed ? "All checks passed\n" : "Some checks failed\n");
+		return passed;
+	}
+
+	PentominoBoard SelfCheck::makeBoard(std::initializer_list<const char*> rows)
+	{
+		std::string cells{};
+		for (const char* row : rows)
+			cells += row;
+		QuietScope quiet{};
+		return PentominoBoard{ cells, static_cast<int>(std::strlen(*rows.begin())), static_cast<int>(rows.size()) };
+	}
+
+	std::vector<std::string> SelfCheck::getSolutionCells()
+	{
+		std::vector<std::string> cells{};
+		for (const PentominoSolver& solution : *PentominoSolver::solutionsFound)
+		{
+			PentominoBoard solved{ solution.mBoard };
+			solved.reLetter();
+			cells.push_back(solved.mBoard);
+		}
+		std::sort(cells.begin(), cells.end());
+		return cells;
+	}
+
+	bool SelfCheck::report(const std::string& name, bool passed, const std::string& detail)
+	{
+		std::cout << (passed ? "pass  " : "FAIL  ") << name << ": " << detail << "\n";
+		return passed;
+	}
+
+	// Without repeats on a board of more than 12 pieces, which pieces repeat depends on the order they're placed in,
+	// so the memoized count has to follow the backtracking search's cell order, neither filling islands by size
+	// nor running transposed
+	bool SelfCheck::checkMemoizedCount(std::initializer_list<const char*> rows, const char* size)
+	{
+		PentominoBoard board{ makeBoard(rows) };
+		WideCount searched{};
+		WideCount counted{};
+		{
+			QuietScope quiet{};
+			PentominoSolver::findAllSolutions(board, true, false, SolveStrategy::Backtrack);
+			searched = PentominoSolver::getCountLastSolution();
+			PentominoSolver::findAllSolutions(board, true, false, SolveStrategy::CountMemoized);
+			counted = PentominoSolver::getCountLastSolution();
+		}
+		return report(std::string{ "CountMemoized matches Backtrack without repeats, " } + size, counted == searched,
+			counted.toString() + " counted, " + searched.toString() + " found");
+	}
+
+	// A wide board searched transposed would fill its cells column by column, which picks other pieces to repeat
+	// than the string search filling them row by row
+	bool SelfCheck::checkSearchOrder()
+	{
+		PentominoBoard board{ makeBoard(cSideBySideRooms) };
+		std::vector<std::string> searched{};
+		std::vector<std::string> scanned{};
+		{
+			QuietScope quiet{};
+			PentominoSolver::findAllSolutions(board, true, false);
+			searched = getSolutionCells();
+			PentominoSolver::solutionsFound->clear();
+			PentominoSolver::searchStrings(board, true, false);
+			scanned = getSolutionCells();
+			PentominoSolver::solutionsFound->clear();
+		}
+		return report("Bitboard search matches the string search without repeats, 65 cells wide", searched == scanned,
+			std::to_string(searched.size()) + " found, " + std::to_string(scanned.size()) + " scanned");
+	}
+
+	// The table findSolutionsAfterEdit() keeps is reused by every board of the same size, including boards that
+	// pieces can repeat on and boards that are transposed
+	bool SelfCheck::checkEdits()
+	{
+		PentominoSolver::clearEditState();
+		bool passed{ true };
+		int edit{ 0 };
+		for (const std::initializer_list<const char*>& rows : { cSideBySideRooms, cSwappedRooms, cSideBySideRooms, cShiftedRooms,
+			cSideBySideRooms })
+		{
+			PentominoBoard board{ makeBoard(rows) };
+			std::vector<std::string> searched{};
+			std::vector<std::string> edited{};
+			{
+				QuietScope quiet{};
+				PentominoSolver::findAllSolutions(board, true, false);
+				searched = getSolutionCells();
+				PentominoSolver::findSolutionsAfterEdit(board, true, false);
+				edited = getSolutionCells();
+			}
+			passed &= report("Solutions after edit " + std::to_string(edit++) + " match findAllSolutions() without repeats",
+				edited == searched, std::to_string(edited.size()) + " after the edit, " + std::to_string(searched.size()) + " found");
+		}
+		PentominoSolver::clearEditState();
+		return passed;
+	}
+
+	// Samples are only uniform if the counts they're drawn by are those of the search's solutions
+	bool SelfCheck::checkSampling()
+	{
+		constexpr int cSamplesPerSolution{ 1000 };
+		PentominoBoard board{ makeBoard(cStackedStrips) };
+		std::map<std::string, int> draws{};
+		{
+			QuietScope quiet{};
+			PentominoSolver::findAllSolutions(board, true, false);
+			for (const std::string& cells : getSolutionCells())
+				draws[cells] = 0;
+			PentominoSolver::sampleSolutions(board, true, static_cast<int>(draws.size()) * cSamplesPerSolution, 1, false);
+		}
+
+		// Every sample is a solution, and every solution is drawn within a fifth of its share, about six standard
+		// deviations
+		std::vector<std::string> samples{ getSolutionCells() };
+		bool passed{ !draws.empty() && samples.size() == draws.size() * cSamplesPerSolution };
+		for (const std::string& cells : samples)
+		{
+			std::map<std::string, int>::iterator found{ draws.find(cells) };
+			if (found == draws.end())
+				passed = false;
+			else
+				found->second++;
+		}
+		int fewest{ cSamplesPerSolution * 2 };
+		int most{ 0 };
+		for (const std::pair<const std::string, int>& drawn : draws)
+		{
+			fewest = std::min(fewest, drawn.second);
+			most = std::max(most, drawn.second);
+		}
+		passed = passed && fewest * 5 >= cSamplesPerSolution * 4 && most * 5 <= cSamplesPerSolution * 6;
+		PentominoSolver::solutionsFound->clear();
+		return report("Samples are uniform over the solutions without repeats, 75 cells", passed,
+			std::to_string(draws.size()) + " solutions drawn " + std::to_string(fewest) + " to " + std::to_string(most)
+			+ " times in " + std::to_string(samples.size()) + " samples");
+	}
+
+	// A cancelled job is still running while its tasks stop, and passes nothing on after cancel() returns but a batch
+	// that was already being passed on
+	bool SelfCheck::checkCancel()
+	{
+		std::atomic<int> batches{ 0 };
+		SolveRequest request{};
+		request.board = makeBoard({ "0000000000", "0000000000", "0000000000", "0000000000", "0000000000", "0000000000" });
+		request.onSolutions = [&batches](const std::vector<std::vector<PlacedPentomino>>&) { ++batches; };
+		request.batchSize = 1;
+		request.ordered = true;
+		std::shared_ptr<SolveJob> job{ PentominoSolver::solveAsync(request) };
+		while (batches == 0 && !job->isDone())
+			std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+		job->cancel();
+		int cancelledAt{ batches };
+		bool runningAfterCancel{ job->isDone() || job->getStatus() == JobStatus::Running };
+		job->wait();
+		bool cancelled{ job->getStatus() == JobStatus::Cancelled };
+		return report("A cancelled job reports Cancelled only once it stops", runningAfterCancel && cancelled
+			&& batches <= cancelledAt + 1, std::to_string(batches - cancelledAt) + " batches after cancel()");
+	}
+
+	// An ordered pipeline holds the solutions of later producers until the earlier ones are passed on, but only so
+	// many of them, after which the later producer waits
+	bool SelfCheck::checkHeldSolutions()
+	{
+		constexpr int cPushes{ 20000 };
+		PentominoBoard board{ makeBoard({ "00000", "00000", "00000", "00000" }) };
+		std::vector<PlacedPentomino> solution{};
+		{
+			QuietScope quiet{};
+			PentominoSolver::findAllSolutions(board, false, false);
+			solution = PentominoSolver::solutionsFound->front().mPlacedPentominoes;
+			PentominoSolver::solutionsFound->clear();
+		}
+
+		// Producer 1 pushes the same solution over and over while producer 0 hasn't finished, so all of it is held
+		std::atomic<int> passedOn{ 0 };
+		std::atomic<int> pushed{ 0 };
+		SolutionPipeline pipeline(board, 2, 1, [&passedOn](const std::vector<PlacedPentomino>&, const std::string&) { ++passedOn; },
+			true);
+		std::thread ahead{ [&pipeline, &pushed, &solution]()
+		{
+			for (int i = 0; i < cPushes; i++)
+			{
+				pipeline.push(1, solution);
+				++pushed;
+			}
+			pipeline.close(1);
+		} };
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 200 });
+		int pushedWhileHeld{ pushed };
+		pipeline.close(0);
+		ahead.join();
+		pipeline.join();
+
+		int bound{ static_cast<int>(SolutionPipeline::cMaxHeld) + SolutionPipeline::cRingCapacity };
+		return report("An ordered pipeline holds a bounded number of solutions", pushedWhileHeld <= bound
+			&& pipeline.getSolutionCount() == cPushes && passedOn == 1,
+			std::to_string(pushedWhileHeld) + " pushed while held, at most " + std::to_string(bound));
+	}
+
+	// Symmetry weighted totals are those of the solutions removeTrivialSolutions() keeps, including boards where
+	// the search finds only some of a solution's symmetric solutions because the order decides which pieces repeat
+	bool SelfCheck::checkStatistics(std::initializer_list<const char*> rows, const char* size)
+	{
+		PentominoBoard board{ makeBoard(rows) };
+		SolutionStatistics weighted{ board, true };
+		SolutionStatistics kept{ board, false };
+		{
+			QuietScope quiet{};
+			PentominoSolver::findStatistics(board, true, weighted, false);
+			PentominoSolver::findAllSolutions(board, true, false);
+		}
+
+		// The first solution of each symmetric set, as removeTrivialSolutions() keeps, without its debug output
+		SolutionCanonicalizer canonicalizer{ board };
+		std::unordered_set<std::string> seen{};
+		for (const PentominoSolver& solution : *PentominoSolver::solutionsFound)
+		{
+			if (seen.insert(canonicalizer.getKey(solution.mBoard.mBoard)).second)
+				kept.add(solution.mPlacedPentominoes);
+		}
+		PentominoSolver::solutionsFound->clear();
+
+		// Weighted totals are whole multiples of a small fraction, so they sum to the kept totals within rounding
+		auto matches{ [](double a, double b) { return a > b - 1e-6 && a < b + 1e-6; } };
+		bool passed{ kept.getSolutionCount() > 0 && matches(weighted.getSolutionCount(), kept.getSolutionCount()) };
+		for (int a = 0; a < Pentomino::cTotalBasePieces; a++)
+		{
+			OrientationBase pieceA{ static_cast<OrientationBase>(a) };
+			passed &= matches(weighted.getPieceCount(pieceA), kept.getPieceCount(pieceA));
+			for (int b = a; b < Pentomino::cTotalBasePieces; b++)
+			{
+				OrientationBase pieceB{ static_cast<OrientationBase>(b) };
+				passed &= matches(weighted.getAdjacencyCount(pieceA, pieceB), kept.getAdjacencyCount(pieceA, pieceB));
+			}
+		}
+		std::ostringstream detail{};
+		detail << weighted.getSolutionCount() << " weighted, " << kept.getSolutionCount() << " kept";
+		return report(std::string{ "Weighted statistics match the non-trivial solutions without repeats, " } + size, passed,
+			detail.str());
+	}
+
+	// An ordered job holds the batches of later tasks until the earlier ones finish, but only so many of them, after
+	// which the later task waits
+	bool SelfCheck::checkHeldBatches()
+	{
+		constexpr int cDeliveries{ 20000 };
+		PentominoBoard board{ makeBoard({ "00000", "00000", "00000", "00000" }) };
+		std::vector<std::vector<PlacedPentomino>> batch{};
+		{
+			QuietScope quiet{};
+			PentominoSolver::findAllSolutions(board, false, false);
+			batch.push_back(PentominoSolver::solutionsFound->front().mPlacedPentominoes);
+			PentominoSolver::solutionsFound->clear();
+		}
+
+		// Task 1 passes on the same batch over and over while task 0 hasn't finished, so all of it is held
+		std::atomic<int> passedOn{ 0 };
+		std::atomic<int> delivered{ 0 };
+		std::shared_ptr<SolveJob> job{ new SolveJob{ [&passedOn](const std::vector<std::vector<PlacedPentomino>>& solutions)
+			{ passedOn += static_cast<int>(solutions.size()); }, 1, true } };
+		job->start(2);
+		std::thread ahead{ [&job, &delivered, &batch]()
+		{
+			for (int i = 0; i < cDeliveries; i++)
+			{
+				job->deliver(1, batch);
+				++delivered;
+			}
+			job->finishTask(1);
+		} };
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 200 });
+		int deliveredWhileHeld{ delivered };
+		job->finishTask(0);
+		ahead.join();
+
+		int bound{ static_cast<int>(SolveJob::cMaxHeld) };
+		return report("An ordered job holds a bounded number of solutions", deliveredWhileHeld <= bound && job->isDone()
+			&& passedOn == cDeliveries, std::to_string(deliveredWhileHeld) + " delivered while held, at most " + std::to_string(bound));
+	}
+
+	// A count strategy counts the same solutions the search stores, walls and repeats included
+	bool SelfCheck::checkCounter(std::initializer_list<const char*> rows, bool minimizeRepeats, SolveStrategy strategy,
+		const std::string& name)
+	{
+		PentominoBoard board{ makeBoard(rows) };
+		WideCount searched{};
+		bool applies{};
+		{
+			QuietScope quiet{};
+			PentominoSolver::findAllSolutions(board, minimizeRepeats, false, SolveStrategy::Backtrack);
+			searched = PentominoSolver::getCountLastSolution();
+			PentominoSolver::solutionsFound->clear();
+			applies = PentominoSolver::countSolutions(board, minimizeRepeats, strategy, false);
+		}
+		WideCount counted{ PentominoSolver::getCountLastSolution() };
+		return report(name, applies && counted == searched,
+			(applies ? counted.toString() + " counted, " : std::string{ "not counted, " }) + searched.toString() + " found");
+	}
+
+	// Without repeats a board of more than 12 pieces uses some twice, which the halves' piece sets can't express
+	bool SelfCheck::checkMeetInTheMiddleRefuses()
+	{
+		PentominoBoard board{ makeBoard(cSideBySideRooms) };
+		bool refused{ !MeetInTheMiddleCounter{ board, true }.canCount() };
+		{
+			QuietScope quiet{};
+			refused = refused && !PentominoSolver::countSolutions(board, true, SolveStrategy::CountMeetInTheMiddle, false);
+		}
+		return report("MeetInTheMiddle refuses a board without repeats of 65 cells", refused,
+			refused ? "not counted" : "counted");
+	}
+
+	// Every placement kernel tests the same candidates, so each finds the same solutions as the Scalar one
+	bool SelfCheck::checkKernels()
+	{
+		PentominoBoard board{ makeBoard(cSideBySideRooms) };
+		PlacementKernel original{ PentominoSolver::getPlacementKernel() };
+		auto solveWith{ [&board](PlacementKernel kernel)
+		{
+			PentominoSolver::setPlacementKernel(kernel);
+			QuietScope quiet{};
+			PentominoSolver::findAllSolutions(board, true, false);
+			std::vector<std::string> cells{ getSolutionCells() };
+			PentominoSolver::solutionsFound->clear();
+			return cells;
+		} };
+
+		std::vector<std::string> scalar{ solveWith(PlacementKernel::Scalar) };
+		bool passed{ !scalar.empty() };
+		for (PlacementKernel kernel : { PlacementKernel::SSE2, PlacementKernel::AVX2, PlacementKernel::Neighborhood })
+		{
+			std::string name{ kernel == PlacementKernel::SSE2 ? "SSE2" : kernel == PlacementKernel::AVX2 ? "AVX2" : "Neighborhood" };
+			name += " kernel matches the Scalar kernel without repeats, 65 cells wide";
+			if (!isPlacementKernelSupported(kernel))
+			{
+				report(name, true, "not supported by this CPU");
+				continue;
+			}
+			std::vector<std::string> found{ solveWith(kernel) };
+			passed &= report(name, found == scalar, std::to_string(found.size()) + " found, " + std::to_string(scalar.size())
+				+ " with Scalar");
+		}
+		PentominoSolver::setPlacementKernel(original);
+		return passed;
+	}
+
+	// The bitboard transforms move every cell where the gather map of CellTransform does, on boards of every
+	// shape up to maxSide cells across that fit in Words words both ways round
+	template <int Words>
+	bool SelfCheck::checkTransforms(int maxSide)
+	{
+		constexpr int cBoards{ 200 };
+		std::mt19937_64 random{ static_cast<uint64_t>(Words) };
+		int mismatches{ 0 };
+		for (int i = 0; i < cBoards; i++)
+		{
+			int width{ static_cast<int>(random() % maxSide) + 1 };
+			int height{ static_cast<int>(random() % maxSide) + 1 };
+			if ((width + 1) * height > BitBoard<Words>::cBits || (height + 1) * width > BitBoard<Words>::cBits)
+				continue;
+			std::string cells(static_cast<std::size_t>(width) * height, '0');
+			BitBoard<Words> board{};
+			for (int cell = 0; cell < width * height; cell++)
+			{
+				if (random() & 1)
+				{
+					cells[cell] = '1';
+					board.set(cell / width * (width + 1) + cell % width);
+				}
+			}
+
+			for (int t = 0; t < cTotalBoardTransforms; t++)
+			{
+				CellTransform transform{ static_cast<BoardTransform>(t), width, height };
+				std::string moved(cells.size(), '0');
+				transform.apply(cells.data(), &moved[0]);
+				BitBoard<Words> expected{};
+				for (int cell = 0; cell < width * height; cell++)
+				{
+					if (moved[cell] == '1')
+						expected.set(cell / transform.getWidth() * (transform.getWidth() + 1) + cell % transform.getWidth());
+				}
+				if (!(transformBitBoard(board, static_cast<BoardTransform>(t), width, height) == expected))
+					mismatches++;
+			}
+		}
+		return report("Bitboard transforms match CellTransform, " + std::to_string(Words) + " words", mismatches == 0,
+			std::to_string(mismatches) + " transforms differ");
+	}
+}
@@ -0,0 +1,60 @@
+#include "SolutionCanonicalizer.h"
+#include "PentominoSolver.h"
+
+namespace Pentominoes
+{
+	SolutionCanonicalizer::SolutionCanonicalizer(const PentominoBoard& board)
+		: mBoard{ board.mBoard }, mWidth{ board.mWidth }
+	{
+		for (int i = 1; i < cTotalBoardTransforms; i++)
+		{
+			BoardTransform transform{ static_cast<BoardTransform>(i) };
+			if (board.isSymmetricUnder(transform))
+				mSymmetries.emplace_back(transform, board.mWidth, board.mHeight);
+		}
+	}
+
+	std::string SolutionCanonicalizer::getKey(const std::string& cells) const
+	{
+		int count{ static_cast<int>(cells.size()) };
+		std::string key{ cells };
+		relabelCells(&key[0], count);
+		std::string transformed(cells.size(), '0');
+		for (const CellTransform& symmetry : mSymmetries)
+		{
+			symmetry.apply(cells.data(), &transformed[0]);
+			relabelCells(&transformed[0], count);
+			if (transformed < key)
+				key = transformed;
+		}
+		return key;
+	}
+
+	int SolutionCanonicalizer::getStabilizerSize(const std::string& cells) const
+	{
+		int count{ static_cast<int>(cells.size()) };
+		std::string relabeled{ cells };
+		relabelCells(&relabeled[0], count);
+		std::string transformed(cells.size(), '0');
+		int size{ 1 };
+		for (const CellTransform& symmetry : mSymmetries)
+		{
+			symmetry.apply(cells.data(), &transformed[0]);
+			relabelCells(&transformed[0], count);
+			if (transformed == relabeled)
+				++size;
+		}
+		return size;
+	}
+
+	std::string SolutionCanonicalizer::getKey(const std::vector<PlacedPentomino>& placements) const
+	{
+		std::string cells{ mBoard };
+		for (const PlacedPentomino& placed : placements)
+		{
+			for (const PieceCell& cell : placed.pentomino.getCells())
+				cells[(placed.position.y + cell.y) * mWidth + placed.position.x + cell.x] = placed.symbol;
+		}
+		return getKey(cells);
+	}
+}
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <array>
+
+#include "SolutionIndex.h"
+#include "PentominoSolver.h"
+
+namespace Pentominoes
+{
+	SolutionIndex::SolutionIndex(int width, int height)
+		: mWidth{ width }, mHeight{ height },
+		mPlacements(static_cast<std::size_t>(Pentomino::cTotalOrientations) * width * height)
+	{
+	}
+
+	uint32_t SolutionIndex::add(const std::vector<PlacedPentomino>& solution)
+	{
+		for (const PlacedPentomino& placed : solution)
+			addPlacement(placed.pentomino, placed.position.x, placed.position.y);
+		return static_cast<uint32_t>(mSolutionCount++);
+	}
+
+	uint32_t SolutionIndex::addSolvedBoard(const std::string& cells)
+	{
+		// Cells of each orientation as a 5x5 mask
+		static const std::array<uint32_t, Pentomino::cTotalOrientations> cShapes{ []()
+		{
+			std::array<uint32_t, Pentomino::cTotalOrientations> shapes{};
+			for (int i = 0; i < Pentomino::cTotalOrientations; i++)
+			{
+				for (const PieceCell& cell : Pentomino(static_cast<PieceOrientation>(i)).getCells())
+					shapes[i] |= 1u << (cell.y * 5 + cell.x);
+			}
+			return shapes;
+		}() };
+
+		// Bounding box and 5x5 shape of each symbol's cells
+		struct Group
+		{
+			int minX{ 255 };
+			int minY{ 255 };
+			std::array<Point, 5> cells{ Point(0, 0), Point(0, 0), Point(0, 0), Point(0, 0), Point(0, 0) };
+			int count{};
+		};
+		std::array<Group, 256> groups{};
+		for (int y = 0; y < mHeight; y++)
+		{
+			for (int x = 0; x < mWidth; x++)
+			{
+				unsigned char symbol{ static_cast<unsigned char>(cells[y * mWidth + x]) };
+				if (symbol == '0' || symbol == '1')
+					continue;
+				Group& group{ groups[symbol] };
+				if (group.count < 5)
+					group.cells[group.count] = Point(x, y);
+				++group.count;
+				group.minX = std::min(group.minX, x);
+				group.minY = std::min(group.minY, y);
+			}
+		}
+
+		for (const Group& group : groups)
+		{
+			if (group.count != 5)
+				continue;
+			uint32_t shape{ 0 };
+			for (const Point& cell : group.cells)
+			{
+				if (cell.x - group.minX < 5 && cell.y - group.minY < 5)
+					shape |= 1u << ((cell.y - group.minY) * 5 + cell.x - group.minX);
+			}
+			auto match{ std::find(cShapes.begin(), cShapes.end(), shape) };
+			if (match != cShapes.end())
+				addPlacement(Pentomino(static_cast<PieceOrientation>(match - cShapes.begin())), group.minX, group.minY);
+		}
+		return static_cast<uint32_t>(mSolutionCount++);
+	}
+
+	std::size_t SolutionIndex::getBytes() const
+	{
+		std::size_t bytes{ mPlacements.size() * sizeof(CompressedBitmap) };
+		for (const CompressedBitmap& bitmap : mPlacements)
+			bytes += bitmap.getBytes();
+		return bytes;
+	}
+
+	const CompressedBitmap& SolutionIndex::find(const Pentomino& piece, const Point& position) const
+	{
+		if (position.x < 0 || position.y < 0 || position.x >= mWidth || position.y >= mHeight)
+			return mEmpty;
+		return mPlacements[(static_cast<std::size_t>(static_cast<int>(piece)) * mHeight + position.y) * mWidth + position.x];
+	}
+
+	CompressedBitmap SolutionIndex::findAll(const std::vector<PlacedPentomino>& placements) const
+	{
+		if (placements.empty())
+			return {};
+		std::vector<const CompressedBitmap*> bitmaps{};
+		for (const PlacedPentomino& placed : placements)
+			bitmaps.push_back(&find(placed.pentomino, placed.position));
+		std::sort(bitmaps.begin(), bitmaps.end(),
+			[](const CompressedBitmap* a, const CompressedBitmap* b) { return a->size() < b->size(); });
+
+		CompressedBitmap result{ *bitmaps[0] };
+		for (std::size_t i = 1; i < bitmaps.size() && !result.isEmpty(); i++)
+			result &= *bitmaps[i];
+		return result;
+	}
+
+	CompressedBitmap SolutionIndex::findAny(const std::vector<PlacedPentomino>& placements) const
+	{
+		CompressedBitmap result{};
+		for (const PlacedPentomino& placed : placements)
+			result |= find(placed.pentomino, placed.position);
+		return result;
+	}
+
+	CompressedBitmap SolutionIndex::findCovering(OrientationBase piece, const Point& cell) const
+	{
+		CompressedBitmap result{};
+		int first{ static_cast<int>(Pentomino::getBaseOrientation(piece)) };
+		for (int i = first; i < first + Pentomino::getNumberOfOrientations(piece); i++)
+		{
+			Pentomino orientation{ static_cast<PieceOrientation>(i) };
+			for (const PieceCell& covered : orientation.getCells())
+				result |= find(orientation, Point(cell.x - covered.x, cell.y - covered.y));
+		}
+		return result;
+	}
+
+	void SolutionIndex::addPlacement(const Pentomino& piece, int x, int y)
+	{
+		mPlacements[(static_cast<std::size_t>(static_cast<int>(piece)) * mHeight + y) * mWidth + x].append(static_cast<uint32_t>(mSolutionCount));
+	}
+}
@@ -0,0 +1,216 @@
+#include <cassert>
+
+#include "SolutionPipeline.h"
+#include "AllocationTracker.h"
+#include "PentominoSolver.h"
+
+namespace Pentominoes
+{
+	SolutionPipeline::SolutionPipeline(const PentominoBoard& board, int producers, int consumers, UniqueCallback onUnique,
+		bool ordered)
+		: mBoard{ board.mBoard }, mWidth{ board.mWidth }, mCanonicalizer{ board }, mOnUnique{ std::move(onUnique) },
+		mOrdered{ ordered }, mProducerCount{ producers }, mProducers{ new Producer[producers] }, mKeyStripes{ new KeyStripe[cKeyStripes] }
+	{
+		assert(board.mBoard.size() <= UINT16_MAX);
+		if (consumers > producers)
+			consumers = producers;
+		for (int i = 0; i < consumers; i++)
+			mConsumers.emplace_back(&SolutionPipeline::consume, this, i, consumers);
+	}
+
+	SolutionPipeline::~SolutionPipeline()
+	{
+		join();
+	}
+
+	void SolutionPipeline::push(int producer, const std::vector<PlacedPentomino>& solution)
+	{
+		assert(solution.size() <= cMaxPlacements);
+		SpscRing<Record, cRingCapacity>& ring{ mProducers[producer].ring };
+		Record* record{ ring.tryAcquire() };
+		while (!record)
+		{
+			// The consumers are behind, wait for a free slot
+			std::this_thread::yield();
+			record = ring.tryAcquire();
+		}
+
+		record->count = static_cast<int>(solution.size());
+		for (int i = 0; i < record->count; i++)
+		{
+			const PlacedPentomino& placed{ solution[i] };
+			record->placements[i].cell = static_cast<uint16_t>(placed.position.y * mWidth + placed.position.x);
+			record->placements[i].orientation = static_cast<uint8_t>(placed.pentomino.getOrientation());
+		}
+		ring.publish();
+	}
+
+	void SolutionPipeline::close(int producer)
+	{
+		mProducers[producer].closed.store(true, std::memory_order_release);
+	}
+
+	void SolutionPipeline::join()
+	{
+		for (int i = 0; i < mProducerCount; i++)
+			close(i);
+		for (std::thread& thread : mConsumers)
+		{
+			thread.join();
+		}
+		mConsumers.clear();
+		// Pass on whatever the consumers left held when they ran out of work
+		if (mOrdered)
+			merge(true);
+	}
+
+	// Drain rings first, first + step, ... until all of them are closed and empty
+	void SolutionPipeline::consume(int first, int step)
+	{
+		// Everything a consumer does is handling solutions for the search threads
+		AllocationScope scope{ AllocationPhase::SolutionHandling };
+		std::vector<PlacedPentomino> solution{};
+		std::string cells{};
+		while (true)
+		{
+			bool progress{ false };
+			bool open{ false };
+			for (int i = first; i < mProducerCount; i += step)
+			{
+				Producer& producer{ mProducers[i] };
+				// Everything pushed before closing is visible once closed is
+				bool closed{ producer.closed.load(std::memory_order_acquire) };
+				bool stalled{ false };
+				while (const Record* record{ producer.ring.front() })
+				{
+					// Leave the rest in the ring until the earlier producers are passed on
+					if (mOrdered && isHeldFull(i))
+					{
+						stalled = true;
+						break;
+					}
+					decode(record->placements, record->count, solution, cells);
+					progress = true;
+
+					mSolutionCount.fetch_add(1, std::memory_order_relaxed);
+					std::string key{ mCanonicalizer.getKey(cells) };
+					if (mOrdered)
+					{
+						// A key already passed on came from an earlier solution, so this one can never be kept
+						if (!containsKey(key))
+						{
+							std::lock_guard<std::mutex> guard{ producer.heldLock };
+							producer.heldKeys.push_back(std::move(key));
+							producer.heldPlacements.insert(producer.heldPlacements.end(), record->placements, record->placements + record->count);
+						}
+						producer.ring.pop();
+						continue;
+					}
+					producer.ring.pop();
+					if (insertKey(std::move(key)))
+					{
+						mUniqueCount.fetch_add(1, std::memory_order_relaxed);
+						std::lock_guard<std::mutex> guard{ mOutputLock };
+						mOnUnique(solution, cells);
+					}
+				}
+				if (mOrdered && closed && !stalled)
+				{
+					std::lock_guard<std::mutex> guard{ producer.heldLock };
+					producer.drained = true;
+				}
+				if (!closed || stalled)
+					open = true;
+			}
+			if (mOrdered)
+				merge(false);
+			if (!open && !progress)
+				return;
+			if (!progress)
+				std::this_thread::yield();
+		}
+	}
+
+	// Rebuild the solution and its board, lettered in placement order
+	void SolutionPipeline::decode(const Placement* placements, int count, std::vector<PlacedPentomino>& solution, std::string& cells) const
+	{
+		solution.clear();
+		cells = mBoard;
+		char symbol{ 'A' };
+		for (int j = 0; j < count; j++)
+		{
+			Pentomino piece{ static_cast<PieceOrientation>(placements[j].orientation) };
+			int anchor{ placements[j].cell };
+			for (const PieceCell& cell : piece.getCells())
+				cells[anchor + cell.y * mWidth + cell.x] = symbol;
+			solution.emplace_back(piece, Point(anchor % mWidth, anchor / mWidth), symbol++);
+		}
+	}
+
+	// Ordered only: pass on the held solutions of the first producers, in producer order, until reaching one
+	// that hasn't drained yet. Without wait, returns right away if another thread is already merging.
+	void SolutionPipeline::merge(bool wait)
+	{
+		std::unique_lock<std::mutex> output{ mOutputLock, std::defer_lock };
+		if (wait)
+			output.lock();
+		else if (!output.try_lock())
+			return;
+
+		std::vector<std::string> keys{};
+		std::vector<Placement> placements{};
+		std::vector<PlacedPentomino> solution{};
+		std::string cells{};
+		while (mNextProducer < mProducerCount)
+		{
+			Producer& producer{ mProducers[mNextProducer] };
+			bool drained{};
+			{
+				std::lock_guard<std::mutex> guard{ producer.heldLock };
+				keys.swap(producer.heldKeys);
+				placements.swap(producer.heldPlacements);
+				drained = producer.drained;
+			}
+			int count{ keys.empty() ? 0 : static_cast<int>(placements.size() / keys.size()) };
+			for (std::size_t i = 0; i < keys.size(); i++)
+			{
+				if (insertKey(std::move(keys[i])))
+				{
+					decode(placements.data() + i * count, count, solution, cells);
+					mUniqueCount.fetch_add(1, std::memory_order_relaxed);
+					mOnUnique(solution, cells);
+				}
+			}
+			keys.clear();
+			placements.clear();
+			// Anything held after the swap is picked up by the next merge
+			if (!drained)
+				return;
+			++mNextProducer;
+		}
+	}
+
+	// Ordered only: returns true if the producer is ahead of the one being passed on and holds as many solutions as it may
+	bool SolutionPipeline::isHeldFull(int producer)
+	{
+		if (producer <= mNextProducer.load())
+			return false;
+		std::lock_guard<std::mutex> guard{ mProducers[producer].heldLock };
+		return mProducers[producer].heldKeys.size() >= cMaxHeld;
+	}
+
+	// Returns true if the key wasn't seen before
+	bool SolutionPipeline::insertKey(std::string&& key)
+	{
+		KeyStripe& stripe{ mKeyStripes[std::hash<std::string>{}(key) % cKeyStripes] };
+		std::lock_guard<std::mutex> guard{ stripe.lock };
+		return stripe.keys.insert(std::move(key)).second;
+	}
+
+	bool SolutionPipeline::containsKey(const std::string& key)
+	{
+		KeyStripe& stripe{ mKeyStripes[std::hash<std::string>{}(key) % cKeyStripes] };
+		std::lock_guard<std::mutex> guard{ stripe.lock };
+		return stripe.keys.count(key) > 0;
+	}
+}
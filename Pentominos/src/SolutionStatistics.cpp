@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <numeric>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+#include "SolutionStatistics.h"
+#include "PentominoSolver.h"
+
+namespace Pentominoes
+{
+	namespace
+	{
+		constexpr const char* cPieceLetters{ "FLNPYTUVWZIX" };
+	}
+
+	SolutionStatistics::SolutionStatistics(const PentominoBoard& board, bool symmetryWeighted)
+		: mBoard{ board.mBoard }, mWidth{ board.getWidth() }, mHeight{ board.getHeight() },
+		mCells(static_cast<std::size_t>(board.getWidth()) * board.getHeight() * Pentomino::cTotalBasePieces)
+	{
+		if (symmetryWeighted)
+		{
+			mCanonicalizer = std::make_shared<SolutionCanonicalizer>(board);
+			mSymmetryCount = static_cast<int>(mCanonicalizer->getSymmetries().size()) + 1;
+			for (int size = 2; size <= mSymmetryCount; size++)
+			{
+				if (mWeightScale % size)
+					mWeightScale *= size / std::gcd(mWeightScale, size);
+			}
+			mTransformBuffer = mBoard;
+			mSetBuffer.assign(mSymmetryCount, mBoard);
+		}
+	}
+
+	void SolutionStatistics::add(const std::vector<PlacedPentomino>& solution)
+	{
+		// Board with each cell marked by the piece covering it
+		int pieces{ static_cast<int>(solution.size()) };
+		mCellsBuffer = mBoard;
+		mPieceOfCell.assign(mBoard.size(), -1);
+		for (int i = 0; i < pieces; i++)
+		{
+			const PlacedPentomino& placed{ solution[i] };
+			for (const PieceCell& cell : placed.pentomino.getCells())
+			{
+				int index{ (placed.position.y + cell.y) * mWidth + placed.position.x + cell.x };
+				mCellsBuffer[index] = placed.symbol;
+				mPieceOfCell[index] = i;
+			}
+		}
+
+		int64_t weight{ mCanonicalizer ? mWeightScale / getSymmetricSetSize(solution) : 1 };
+		mSolutions += weight;
+		for (int i = 0; i < static_cast<int>(mPieceOfCell.size()); i++)
+		{
+			if (mPieceOfCell[i] >= 0)
+				mCells[static_cast<std::size_t>(i) * Pentomino::cTotalBasePieces + static_cast<int>(solution[mPieceOfCell[i]].pentomino.getBasePiece())] += weight;
+		}
+		for (const PlacedPentomino& placed : solution)
+			mOrientations[static_cast<int>(placed.pentomino)] += weight;
+
+		// Each pair of pieces counts once however many edges they share
+		mAdjacentPieces.assign(static_cast<std::size_t>(pieces) * pieces, false);
+		for (int y = 0; y < mHeight; y++)
+		{
+			for (int x = 0; x < mWidth; x++)
+			{
+				int piece{ mPieceOfCell[y * mWidth + x] };
+				if (piece < 0)
+					continue;
+				int right{ x + 1 < mWidth ? mPieceOfCell[y * mWidth + x + 1] : -1 };
+				int below{ y + 1 < mHeight ? mPieceOfCell[(y + 1) * mWidth + x] : -1 };
+				for (int other : { right, below })
+				{
+					if (other < 0 || other == piece)
+						continue;
+					int first{ std::min(piece, other) };
+					int second{ std::max(piece, other) };
+					if (mAdjacentPieces[static_cast<std::size_t>(first) * pieces + second])
+						continue;
+					mAdjacentPieces[static_cast<std::size_t>(first) * pieces + second] = true;
+					mAdjacency[getPairIndex(static_cast<int>(solution[first].pentomino.getBasePiece()),
+						static_cast<int>(solution[second].pentomino.getBasePiece()))] += weight;
+				}
+			}
+		}
+	}
+
+	// Number of distinct solutions the one in the buffers maps to under the board's symmetries, counting itself
+	int SolutionStatistics::getSymmetricSetSize(const std::vector<PlacedPentomino>& solution)
+	{
+		// A solution with s symmetries mapping it onto itself is one of (symmetries / s) symmetric solutions
+		if (!mRepeatsFollowOrder)
+			return mSymmetryCount / mCanonicalizer->getStabilizerSize(mCellsBuffer);
+
+		int count{ static_cast<int>(mCellsBuffer.size()) };
+		int size{ 1 };
+		mSetBuffer[0] = mCellsBuffer;
+		relabelCells(&mSetBuffer[0][0], count);
+		for (const CellTransform& symmetry : mCanonicalizer->getSymmetries())
+		{
+			if (!isInSearchOrder(solution, symmetry))
+				continue;
+			symmetry.apply(mCellsBuffer.data(), &mTransformBuffer[0]);
+			relabelCells(&mTransformBuffer[0], count);
+			if (std::find(mSetBuffer.begin(), mSetBuffer.begin() + size, mTransformBuffer) == mSetBuffer.begin() + size)
+				mSetBuffer[size++] = mTransformBuffer;
+		}
+		return size;
+	}
+
+	// Returns true if the search finds the transformed solution in the buffers too. The search places the pieces in
+	// the order of their first cells, and has to use every piece once before using any of them again.
+	bool SolutionStatistics::isInSearchOrder(const std::vector<PlacedPentomino>& solution, const CellTransform& transform)
+	{
+		int uses[Pentomino::cTotalBasePieces]{};
+		int placed{ 0 };
+		mPiecePlaced.assign(solution.size(), false);
+		for (int i = 0; i < static_cast<int>(mPieceOfCell.size()); i++)
+		{
+			int piece{ mPieceOfCell[transform.getSource(i)] };
+			if (piece < 0 || mPiecePlaced[piece])
+				continue;
+			mPiecePlaced[piece] = true;
+			int base{ static_cast<int>(solution[piece].pentomino.getBasePiece()) };
+			if (uses[base] > placed / Pentomino::cTotalBasePieces)
+				return false;
+			uses[base]++;
+			placed++;
+		}
+		return true;
+	}
+
+	void SolutionStatistics::merge(const SolutionStatistics& other)
+	{
+		mSolutions += other.mSolutions;
+		for (std::size_t i = 0; i < mCells.size(); i++)
+			mCells[i] += other.mCells[i];
+		for (int i = 0; i < Pentomino::cTotalOrientations; i++)
+			mOrientations[i] += other.mOrientations[i];
+		for (int i = 0; i < cAdjacencyPairs; i++)
+			mAdjacency[i] += other.mAdjacency[i];
+	}
+
+	void SolutionStatistics::clear()
+	{
+		mSolutions = 0;
+		std::fill(mCells.begin(), mCells.end(), 0);
+		std::fill(std::begin(mOrientations), std::end(mOrientations), 0);
+		std::fill(std::begin(mAdjacency), std::end(mAdjacency), 0);
+	}
+
+	double SolutionStatistics::getPieceCount(OrientationBase piece) const
+	{
+		int first{ static_cast<int>(Pentomino::getBaseOrientation(piece)) };
+		int64_t total{ 0 };
+		for (int i = first; i < first + Pentomino::getNumberOfOrientations(piece); i++)
+			total += mOrientations[i];
+		return getWeighted(total);
+	}
+
+	double SolutionStatistics::getAdjacencyCount(OrientationBase a, OrientationBase b) const
+	{
+		return getWeighted(mAdjacency[getPairIndex(static_cast<int>(a), static_cast<int>(b))]);
+	}
+
+	void SolutionStatistics::printHeatmap(OrientationBase piece) const
+	{
+		double solutions{ getSolutionCount() };
+		std::streamsize precision{ std::cout.precision() };
+		std::cout << "Share of solutions with " << cPieceLetters[static_cast<int>(piece)] << " on each cell (%):\n";
+		for (int y = 0; y < mHeight; y++)
+		{
+			for (int x = 0; x < mWidth; x++)
+			{
+				if (mBoard[y * mWidth + x] != '0')
+					std::cout << std::setw(5) << "#";
+				else
+					std::cout << std::setw(5) << std::fixed << std::setprecision(0)
+						<< (solutions > 0 ? getCellCount(piece, x, y) * 100.0 / solutions : 0.0);
+			}
+			std::cout << "\n";
+		}
+		std::cout << std::defaultfloat << std::setprecision(precision);
+	}
+
+	void SolutionStatistics::printTables() const
+	{
+		double solutions{ getSolutionCount() };
+		double scale{ solutions > 0 ? 1.0 / solutions : 0.0 };
+		std::streamsize precision{ std::cout.precision() };
+		std::cout << "Solutions: " << solutions << "\n";
+		std::cout << std::fixed << std::setprecision(2);
+
+		std::cout << "Placements per solution:\n";
+		for (int base = 0; base < Pentomino::cTotalBasePieces; base++)
+		{
+			OrientationBase piece{ static_cast<OrientationBase>(base) };
+			std::cout << cPieceLetters[base] << std::setw(7) << getPieceCount(piece) * scale << " |";
+			int first{ static_cast<int>(Pentomino::getBaseOrientation(piece)) };
+			for (int i = first; i < first + Pentomino::getNumberOfOrientations(piece); i++)
+			{
+				Pentomino orientation{ static_cast<PieceOrientation>(i) };
+				std::cout << " " << orientation.getLabelString() << " " << getOrientationCount(orientation) * scale;
+			}
+			std::cout << "\n";
+		}
+
+		std::cout << "Adjacent pairs per solution:\n ";
+		for (int base = 0; base < Pentomino::cTotalBasePieces; base++)
+			std::cout << std::setw(6) << cPieceLetters[base];
+		std::cout << "\n";
+		for (int a = 0; a < Pentomino::cTotalBasePieces; a++)
+		{
+			std::cout << cPieceLetters[a];
+			for (int b = 0; b < Pentomino::cTotalBasePieces; b++)
+				std::cout << std::setw(6) << getAdjacencyCount(static_cast<OrientationBase>(a), static_cast<OrientationBase>(b)) * scale;
+			std::cout << "\n";
+		}
+		std::cout << std::defaultfloat << std::setprecision(precision);
+	}
+
+	// Row a of the upper triangle, a <= b, starts after the a rows before it
+	int SolutionStatistics::getPairIndex(int a, int b)
+	{
+		if (a > b)
+			std::swap(a, b);
+		return a * Pentomino::cTotalBasePieces - a * (a - 1) / 2 + b - a;
+	}
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <iterator>
+
+#include "SolveJob.h"
+#include "PentominoSolver.h"
+
+namespace Pentominoes
+{
+	SolveJob::SolveJob(SolutionBatchCallback onSolutions, int batchSize, bool ordered)
+		: mOnSolutions{ std::move(onSolutions) }, mBatchSize{ std::max(batchSize, 1) }, mOrdered{ ordered && mOnSolutions }
+	{
+	}
+
+	SolveProgress SolveJob::getProgress() const
+	{
+		SolveProgress progress{};
+		progress.nodes = mNodes.load(std::memory_order_relaxed);
+		progress.solutions = mSolutions.load(std::memory_order_relaxed);
+		progress.completion = mTasks > 0 ? static_cast<double>(mTasks - mTasksLeft.load()) / mTasks : isDone() ? 1.0 : 0.0;
+		return progress;
+	}
+
+	JobStatus SolveJob::getStatus() const
+	{
+		if (mUnsupported)
+			return JobStatus::Unsupported;
+		// Cancelled only once every task has stopped, until then a task may still be in the callback
+		if (!isDone())
+			return JobStatus::Running;
+		return mCancelled ? JobStatus::Cancelled : JobStatus::Finished;
+	}
+
+	void SolveJob::cancel()
+	{
+		mCancelled = true;
+		mHeldSignal.notify_all();
+	}
+
+	bool SolveJob::isDone() const
+	{
+		std::lock_guard<std::mutex> guard{ mDoneLock };
+		return mDone;
+	}
+
+	void SolveJob::wait()
+	{
+		std::unique_lock<std::mutex> guard{ mDoneLock };
+		mDoneSignal.wait(guard, [this]() { return mDone; });
+	}
+
+	void SolveJob::start(int tasks, bool unsupported)
+	{
+		mTasks = tasks;
+		mTasksLeft = tasks;
+		mUnsupported = unsupported;
+		if (mOrdered)
+		{
+			mTaskFinished.assign(tasks, false);
+			mHeld.resize(tasks);
+		}
+		if (tasks == 0)
+			finish();
+	}
+
+	void SolveJob::deliver(int task, const std::vector<std::vector<PlacedPentomino>>& batch)
+	{
+		if (!mOnSolutions || batch.empty())
+			return;
+		std::unique_lock<std::mutex> guard{ mCallbackLock };
+		if (mOrdered)
+		{
+			// cancel() doesn't take the lock, since the callback may call it, so a wake-up it sends just before
+			// the wait is caught by the timeout
+			while (!mCancelled && task != mNextTask && mHeld[task].size() >= cMaxHeld)
+				mHeldSignal.wait_for(guard, std::chrono::milliseconds{ 10 });
+		}
+		if (mCancelled)
+			return;
+		if (!mOrdered || task == mNextTask)
+			mOnSolutions(batch);
+		else
+			mHeld[task].insert(mHeld[task].end(), batch.begin(), batch.end());
+	}
+
+	// The last task to finish wakes the waiters, after every batch has been passed on
+	void SolveJob::finishTask(int task)
+	{
+		if (mOrdered)
+		{
+			// Move on past every finished task, passing on what each of them held back unless the job was cancelled
+			std::lock_guard<std::mutex> guard{ mCallbackLock };
+			mTaskFinished[task] = true;
+			while (mNextTask < mTasks && mTaskFinished[mNextTask])
+			{
+				if (++mNextTask < mTasks && !mCancelled)
+					releaseHeld(mNextTask);
+			}
+			if (mCancelled)
+			{
+				// Nothing held will be passed on anymore
+				for (std::vector<std::vector<PlacedPentomino>>& held : mHeld)
+					std::vector<std::vector<PlacedPentomino>>{}.swap(held);
+			}
+			mHeldSignal.notify_all();
+		}
+		if (mTasksLeft.fetch_sub(1) == 1)
+			finish();
+	}
+
+	// Precondition: mCallbackLock is held
+	void SolveJob::releaseHeld(int task)
+	{
+		std::vector<std::vector<PlacedPentomino>> held{};
+		held.swap(mHeld[task]);
+		for (std::size_t first = 0; first < held.size(); first += mBatchSize)
+		{
+			std::size_t last{ std::min(first + mBatchSize, held.size()) };
+			mOnSolutions(std::vector<std::vector<PlacedPentomino>>(std::make_move_iterator(held.begin() + first),
+				std::make_move_iterator(held.begin() + last)));
+		}
+	}
+
+	void SolveJob::finish()
+	{
+		{
+			std::lock_guard<std::mutex> guard{ mDoneLock };
+			mDone = true;
+		}
+		mDoneSignal.notify_all();
+	}
+}
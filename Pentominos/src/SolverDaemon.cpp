@@ -0,0 +1,746 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "SolverDaemon.h"
+#include "BitBoardSolver.h"
+#include "BoardParser.h"
+#include "NeighborhoodTable.h"
+#include "PentominoSolver.h"
+#include "SolutionCanonicalizer.h"
+#include "ThreadPool.h"
+
+namespace Pentominoes
+{
+	namespace
+	{
+		constexpr std::size_t cMaxRequestBytes{ 1 << 20 };
+		constexpr std::chrono::milliseconds cPollInterval{ 10 }; // How often a running job is checked against its limits
+
+		// The platform layer: a listening socket and one socket per connection, or on Windows a new
+		// instance of the named pipe for each connection
+#if defined(_WIN32)
+		bool openListener(const std::string& endpoint, std::intptr_t& listener)
+		{
+			listener = 0;
+			return true;
+		}
+
+		bool acceptChannel(const std::string& endpoint, std::intptr_t listener, std::intptr_t& channel)
+		{
+			HANDLE pipe{ CreateNamedPipeA(endpoint.c_str(), PIPE_ACCESS_DUPLEX, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+				PIPE_UNLIMITED_INSTANCES, 1 << 16, 1 << 16, 0, nullptr) };
+			if (pipe == INVALID_HANDLE_VALUE)
+				return false;
+			if (!ConnectNamedPipe(pipe, nullptr) && GetLastError() != ERROR_PIPE_CONNECTED)
+			{
+				CloseHandle(pipe);
+				return false;
+			}
+			channel = reinterpret_cast<std::intptr_t>(pipe);
+			return true;
+		}
+
+		// Connect to the pipe, which wakes a thread waiting in ConnectNamedPipe()
+		void wakeListener(const std::string& endpoint, std::intptr_t listener)
+		{
+			HANDLE client{ CreateFileA(endpoint.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr) };
+			if (client != INVALID_HANDLE_VALUE)
+				CloseHandle(client);
+		}
+
+		void closeListener(const std::string& endpoint, std::intptr_t listener)
+		{
+		}
+
+		int readChannel(std::intptr_t channel, char* buffer, int size)
+		{
+			DWORD bytes{};
+			if (!ReadFile(reinterpret_cast<HANDLE>(channel), buffer, size, &bytes, nullptr))
+				return 0;
+			return static_cast<int>(bytes);
+		}
+
+		bool writeChannel(std::intptr_t channel, const std::string& text)
+		{
+			std::size_t written{ 0 };
+			while (written < text.size())
+			{
+				DWORD bytes{};
+				if (!WriteFile(reinterpret_cast<HANDLE>(channel), text.data() + written, static_cast<DWORD>(text.size() - written), &bytes, nullptr))
+					return false;
+				written += bytes;
+			}
+			return true;
+		}
+
+		// Stops a blocked read so the connection's thread can finish
+		void wakeChannel(std::intptr_t channel)
+		{
+			CancelIoEx(reinterpret_cast<HANDLE>(channel), nullptr);
+		}
+
+		void closeChannel(std::intptr_t channel)
+		{
+			HANDLE pipe{ reinterpret_cast<HANDLE>(channel) };
+			FlushFileBuffers(pipe);
+			DisconnectNamedPipe(pipe);
+			CloseHandle(pipe);
+		}
+
+		std::string getPeerName(std::intptr_t channel)
+		{
+			ULONG process{};
+			if (GetNamedPipeClientProcessId(reinterpret_cast<HANDLE>(channel), &process))
+				return "pid-" + std::to_string(process);
+			return "anonymous";
+		}
+#else
+		bool openListener(const std::string& endpoint, std::intptr_t& listener)
+		{
+			sockaddr_un address{};
+			address.sun_family = AF_UNIX;
+			if (endpoint.size() >= sizeof(address.sun_path))
+				return false;
+			std::memcpy(address.sun_path, endpoint.c_str(), endpoint.size() + 1);
+
+			int socketFd{ socket(AF_UNIX, SOCK_STREAM, 0) };
+			if (socketFd < 0)
+				return false;
+			// A socket file left behind by a daemon that didn't shut down cleanly
+			unlink(endpoint.c_str());
+			if (bind(socketFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(socketFd, SOMAXCONN) != 0)
+			{
+				::close(socketFd);
+				return false;
+			}
+			listener = socketFd;
+			return true;
+		}
+
+		bool acceptChannel(const std::string&, std::intptr_t listener, std::intptr_t& channel)
+		{
+			int socketFd{ -1 };
+			do
+			{
+				socketFd = accept(static_cast<int>(listener), nullptr, nullptr);
+			} while (socketFd < 0 && errno == EINTR);
+			channel = socketFd;
+			return socketFd >= 0;
+		}
+
+		// Shutting down the socket makes a blocked accept() return
+		void wakeListener(const std::string&, std::intptr_t listener)
+		{
+			shutdown(static_cast<int>(listener), SHUT_RDWR);
+		}
+
+		void closeListener(const std::string& endpoint, std::intptr_t listener)
+		{
+			::close(static_cast<int>(listener));
+			unlink(endpoint.c_str());
+		}
+
+		int readChannel(std::intptr_t channel, char* buffer, int size)
+		{
+			ssize_t bytes{ -1 };
+			do
+			{
+				bytes = recv(static_cast<int>(channel), buffer, size, 0);
+			} while (bytes < 0 && errno == EINTR);
+			return bytes > 0 ? static_cast<int>(bytes) : 0;
+		}
+
+		bool writeChannel(std::intptr_t channel, const std::string& text)
+		{
+#if defined(MSG_NOSIGNAL)
+			constexpr int cFlags{ MSG_NOSIGNAL }; // A client that hung up shouldn't kill the daemon
+#else
+			constexpr int cFlags{ 0 };
+#endif
+			std::size_t written{ 0 };
+			while (written < text.size())
+			{
+				ssize_t bytes{ send(static_cast<int>(channel), text.data() + written, text.size() - written, cFlags) };
+				if (bytes < 0 && errno == EINTR)
+					continue;
+				if (bytes <= 0)
+					return false;
+				written += bytes;
+			}
+			return true;
+		}
+
+		void wakeChannel(std::intptr_t channel)
+		{
+			shutdown(static_cast<int>(channel), SHUT_RDWR);
+		}
+
+		void closeChannel(std::intptr_t channel)
+		{
+			::close(static_cast<int>(channel));
+		}
+
+		std::string getPeerName(std::intptr_t channel)
+		{
+#if defined(SO_PEERCRED)
+			ucred credentials{};
+			socklen_t length{ sizeof(credentials) };
+			if (getsockopt(static_cast<int>(channel), SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0)
+				return "pid-" + std::to_string(credentials.pid);
+#endif
+			return "anonymous";
+		}
+#endif
+
+		// A request is complete once a blank line follows its first line
+		bool isComplete(const std::string& text)
+		{
+			std::size_t header{ text.find('\n') };
+			if (header == std::string::npos)
+				return false;
+			return text.find("\n\n", header) != std::string::npos || text.find("\n\r\n", header) != std::string::npos;
+		}
+
+		double getSeconds(std::chrono::steady_clock::duration duration)
+		{
+			return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+		}
+
+		// Returns false unless the whole text is a number of at least 0
+		bool parseCount(const char* text, int64_t& value)
+		{
+			char* end{};
+			errno = 0;
+			long long parsed{ std::strtoll(text, &end, 10) };
+			if (end == text || *end != '\0' || errno != 0 || parsed < 0)
+				return false;
+			value = parsed;
+			return true;
+		}
+
+		bool parseSeconds(const char* text, double& value)
+		{
+			char* end{};
+			double parsed{ std::strtod(text, &end) };
+			if (end == text || *end != '\0' || !(parsed >= 0))
+				return false;
+			value = parsed;
+			return true;
+		}
+	}
+
+	const char* SolverDaemon::getDefaultEndpoint()
+	{
+#if defined(_WIN32)
+		return "\\\\.\\pipe\\pentominos";
+#else
+		return "/tmp/pentominos.sock";
+#endif
+	}
+
+	SolverDaemon::SolverDaemon(std::string endpoint, std::string metricsPath)
+		: mEndpoint{ std::move(endpoint) }, mMetricsPath{ std::move(metricsPath) }
+	{
+	}
+
+	SolverDaemon::~SolverDaemon()
+	{
+		stop();
+	}
+
+	bool SolverDaemon::run()
+	{
+		std::intptr_t listener{ -1 };
+		if (mStopping || !openListener(mEndpoint, listener))
+			return false;
+		mListener = listener;
+
+		// Build the shared tables and start the workers before the first request instead of during it
+		ThreadPool::get();
+		NeighborhoodTable::get();
+		writeMetrics();
+
+		std::thread scheduler{ [this]() { schedule(); } };
+		while (!mStopping)
+		{
+			std::intptr_t channel{};
+			if (!acceptChannel(mEndpoint, listener, channel))
+				break;
+			if (mStopping)
+			{
+				closeChannel(channel);
+				break;
+			}
+
+			std::lock_guard<std::mutex> guard{ mConnectionLock };
+			for (auto it = mConnections.begin(); it != mConnections.end();)
+			{
+				if (it->done)
+				{
+					it->thread.join();
+					it = mConnections.erase(it);
+				}
+				else
+					++it;
+			}
+			Connection& connection{ mConnections.emplace_back() };
+			connection.channel = channel;
+			connection.thread = std::thread([this, &connection]()
+			{
+				serveConnection(connection.channel);
+				connection.done = true;
+			});
+		}
+
+		mStopping = true;
+		mQueueSignal.notify_all();
+		scheduler.join();
+		{
+			std::lock_guard<std::mutex> guard{ mConnectionLock };
+			for (Connection& connection : mConnections)
+			{
+				if (!connection.done)
+					wakeChannel(connection.channel);
+				connection.thread.join();
+			}
+			mConnections.clear();
+		}
+		mListener = -1;
+		closeListener(mEndpoint, listener);
+		return true;
+	}
+
+	void SolverDaemon::stop()
+	{
+		if (mStopping.exchange(true))
+			return;
+		mQueueSignal.notify_all();
+		std::intptr_t listener{ mListener };
+		if (listener >= 0)
+			wakeListener(mEndpoint, listener);
+	}
+
+	// Reads one request, waits for its turn and writes the reply
+	void SolverDaemon::serveConnection(std::intptr_t channel)
+	{
+		std::string text{};
+		char buffer[4096];
+		while (text.size() < cMaxRequestBytes && !isComplete(text))
+		{
+			int bytes{ readChannel(channel, buffer, sizeof(buffer)) };
+			if (bytes == 0)
+				break;
+			text.append(buffer, bytes);
+		}
+
+		std::unique_ptr<Request> request{ std::make_unique<Request>() };
+		request->client = getPeerName(channel);
+		std::string reply{};
+		std::size_t headerEnd{ text.find('\n') };
+		std::istringstream header{ text.substr(0, headerEnd) };
+		std::string token{};
+		header >> token;
+		if (token != "solve")
+			reply = "error expected solve\n";
+		while (reply.empty() && header >> token)
+		{
+			if (token == "-D")
+				request->minimizeRepeats = false;
+			else if (token == "-T")
+				request->keepTrivial = true;
+			else if (token == "count")
+				request->countOnly = true;
+			else if (token.compare(0, 6, "first=") == 0)
+			{
+				if (!parseCount(token.c_str() + 6, request->first))
+					reply = "error bad option " + token + "\n";
+			}
+			else if (token.compare(0, 8, "timeout=") == 0)
+			{
+				if (!parseSeconds(token.c_str() + 8, request->timeout))
+					reply = "error bad option " + token + "\n";
+			}
+			else if (token.compare(0, 7, "client=") == 0)
+				request->client = token.substr(7);
+			else
+				reply = "error unknown option " + token + "\n";
+		}
+
+		if (reply.empty())
+		{
+			std::size_t boardStart{ headerEnd == std::string::npos ? text.size() : headerEnd + 1 };
+			BoardParser parser{ text.data() + boardStart, text.size() - boardStart };
+			if (!parser.next(request->board) || request->board.getWidth() == 0)
+				reply = "error no board\n";
+		}
+
+		if (reply.empty())
+		{
+			std::future<std::string> result{ request->reply.get_future() };
+			if (enqueue(std::move(request)))
+				reply = result.get();
+			else
+				reply = "error queue full\n";
+		}
+		writeChannel(channel, reply);
+		closeChannel(channel);
+	}
+
+	// Returns false if the daemon is stopping or too many requests are waiting
+	bool SolverDaemon::enqueue(std::unique_ptr<Request> request)
+	{
+		{
+			std::lock_guard<std::mutex> guard{ mQueueLock };
+			if (mStopping || mQueued >= cMaxQueued)
+				return false;
+			std::deque<std::unique_ptr<Request>>& queue{ mQueues[request->client] };
+			if (queue.empty())
+				mTurns.push_back(request->client);
+			request->queued = std::chrono::steady_clock::now();
+			queue.push_back(std::move(request));
+			++mQueued;
+		}
+		mQueueSignal.notify_one();
+		writeMetrics();
+		return true;
+	}
+
+	// Runs one request of each waiting client in turn, so every client waits for at most one request
+	// of each other client before its next one runs
+	void SolverDaemon::schedule()
+	{
+		while (true)
+		{
+			std::unique_ptr<Request> request{};
+			{
+				std::unique_lock<std::mutex> guard{ mQueueLock };
+				mQueueSignal.wait(guard, [this]() { return mStopping || !mTurns.empty(); });
+				if (mStopping)
+					break;
+				std::string client{ std::move(mTurns.front()) };
+				mTurns.pop_front();
+				auto queue{ mQueues.find(client) };
+				request = std::move(queue->second.front());
+				queue->second.pop_front();
+				if (queue->second.empty())
+					mQueues.erase(queue);
+				else
+					mTurns.push_back(std::move(client));
+				--mQueued;
+			}
+
+			JobRecord record{};
+			record.client = request->client;
+			record.width = request->board.getWidth();
+			record.height = request->board.getHeight();
+			std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+			record.queuedSeconds = getSeconds(start - request->queued);
+			{
+				std::lock_guard<std::mutex> guard{ mMetricsLock };
+				record.id = mNextJobId++;
+				mRunning = true;
+			}
+			writeMetrics();
+
+			std::string reply{ solve(*request, record) };
+			record.runSeconds = getSeconds(std::chrono::steady_clock::now() - start);
+			request->reply.set_value(std::move(reply));
+			{
+				std::lock_guard<std::mutex> guard{ mMetricsLock };
+				mRunning = false;
+				++mJobsCompleted;
+				mTotalRunSeconds += record.runSeconds;
+				mRecentJobs.push_front(std::move(record));
+				if (mRecentJobs.size() > cRecentJobs)
+					mRecentJobs.pop_back();
+			}
+			writeMetrics();
+		}
+
+		// Turn away whatever is still waiting
+		std::lock_guard<std::mutex> guard{ mQueueLock };
+		for (auto& [client, queue] : mQueues)
+		{
+			for (std::unique_ptr<Request>& request : queue)
+				request->reply.set_value("error daemon stopping\n");
+		}
+		mQueues.clear();
+		mTurns.clear();
+		mQueued = 0;
+	}
+
+	// Solves the board in its canonical orientation, the smallest of its transformations, so that every
+	// rotation and reflection of a board shares one cache entry. Solutions are turned back to the
+	// orientation of the request before they're written out.
+	// Without repeats, a board of more than 12 pieces has other solutions in another orientation, since the pieces
+	// it repeats depend on the order its cells are filled in. Such a board is solved and cached as given.
+	std::string SolverDaemon::solve(const Request& request, JobRecord& record)
+	{
+		const PentominoBoard& board{ request.board };
+		bool ownOrientation{ BitBoardSolver<1>::repeatsFollowOrder(board, request.minimizeRepeats) };
+		BoardTransform toCanonical{ BoardTransform::Identity };
+		std::string canonicalCells{};
+		int canonicalWidth{};
+		int canonicalHeight{};
+		for (int i = 0; i < (ownOrientation ? 1 : cTotalBoardTransforms); i++)
+		{
+			CellTransform transform{ static_cast<BoardTransform>(i), board.mWidth, board.mHeight };
+			std::string cells(board.mBoard.size(), '1');
+			transform.apply(board.mBoard.data(), &cells[0]);
+			bool smaller{ i == 0 || transform.getWidth() < canonicalWidth
+				|| (transform.getWidth() == canonicalWidth && cells < canonicalCells) };
+			if (smaller)
+			{
+				toCanonical = static_cast<BoardTransform>(i);
+				canonicalCells = std::move(cells);
+				canonicalWidth = transform.getWidth();
+				canonicalHeight = transform.getHeight();
+			}
+		}
+		std::string key{ request.minimizeRepeats ? "N" : "D" };
+		key += request.keepTrivial ? "T" : "U";
+		key += ownOrientation ? "O " : " ";
+		key += std::to_string(canonicalWidth) + "x" + std::to_string(canonicalHeight) + " " + canonicalCells;
+
+		std::shared_ptr<const CacheEntry> entry{ findCached(key, !request.countOnly) };
+		record.cached = entry != nullptr;
+		std::string status{ "finished" };
+		if (!entry && request.countOnly && request.timeout <= 0)
+		{
+			std::shared_ptr<CacheEntry> result{ std::make_shared<CacheEntry>() };
+			if (countCanonical(request, PentominoBoard{ canonicalCells, canonicalWidth, canonicalHeight }, result->count))
+			{
+				storeCached(key, result);
+				entry = result;
+			}
+		}
+		if (!entry)
+		{
+			PentominoBoard canonical{ canonicalCells, canonicalWidth, canonicalHeight };
+			SolutionCanonicalizer canonicalizer{ canonical };
+			std::unordered_set<std::string> seen{};
+			std::atomic<int64_t> found{ 0 };
+			std::shared_ptr<CacheEntry> result{ std::make_shared<CacheEntry>() };
+			result->hasSolutions = !request.countOnly;
+
+			SolveRequest solveRequest{};
+			solveRequest.board = canonical;
+			solveRequest.minimizeRepeats = request.minimizeRepeats;
+			// Same solutions in the same order on every run, so first=N and the cache agree with a full search
+			solveRequest.ordered = !request.countOnly;
+			bool useCallback{ !request.countOnly || !request.keepTrivial };
+			if (useCallback)
+			{
+				solveRequest.onSolutions = [&](const std::vector<std::vector<PlacedPentomino>>& batch)
+				{
+					for (const std::vector<PlacedPentomino>& solution : batch)
+					{
+						if (request.first > 0 && found >= request.first)
+							return;
+						std::string cells{ canonicalCells };
+						for (const PlacedPentomino& placed : solution)
+						{
+							for (const PieceCell& cell : placed.pentomino.getCells())
+								cells[(placed.position.y + cell.y) * canonicalWidth + placed.position.x + cell.x] = placed.symbol;
+						}
+						if (!request.keepTrivial && !seen.insert(canonicalizer.getKey(cells)).second)
+							continue;
+						++found;
+						if (result->hasSolutions)
+							result->solutions.push_back(std::move(cells));
+					}
+				};
+			}
+
+			std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+			std::shared_ptr<SolveJob> job{ PentominoSolver::solveAsync(solveRequest) };
+			while (!job->waitFor(cPollInterval))
+			{
+				int64_t count{ useCallback ? found.load() : job->getProgress().solutions };
+				bool enough{ request.first > 0 && count >= request.first };
+				bool late{ request.timeout > 0 && getSeconds(std::chrono::steady_clock::now() - start) > request.timeout };
+				if (enough || late)
+				{
+					job->cancel();
+					job->wait();
+					if (late && !enough)
+						status = "timeout";
+					break;
+				}
+			}
+
+			result->count = useCallback ? found.load() : job->getProgress().solutions;
+			if (request.first > 0 && result->count >= request.first)
+			{
+				result->count = request.first;
+				status = "first";
+			}
+			if (job->getStatus() == JobStatus::Unsupported)
+				status = "unsupported";
+			else if (job->getStatus() == JobStatus::Finished && status == "finished")
+			{
+				// Only complete results are kept, and only a count for the largest of them
+				std::shared_ptr<CacheEntry> cached{ result };
+				if (result->hasSolutions && result->count > cMaxCachedSolutions)
+				{
+					cached = std::make_shared<CacheEntry>();
+					cached->count = result->count;
+				}
+				storeCached(key, cached);
+			}
+			entry = result;
+		}
+		else if (request.first > 0 && entry->count >= request.first)
+			status = "first";
+
+		int64_t count{ request.first > 0 && entry->count > request.first ? request.first : entry->count };
+		record.status = status;
+		record.solutions = count;
+		std::string reply{ "status " + status + " solutions " + std::to_string(count) + " seconds "
+			+ std::to_string(getSeconds(std::chrono::steady_clock::now() - request.queued)) + " cached " + (record.cached ? "1" : "0") + "\n" };
+		if (!request.countOnly)
+		{
+			CellTransform toRequest{ getInverse(toCanonical), canonicalWidth, canonicalHeight };
+			std::string cells(canonicalCells.size(), '1');
+			for (int64_t i = 0; i < count && i < static_cast<int64_t>(entry->solutions.size()); i++)
+			{
+				toRequest.apply(entry->solutions[i].data(), &cells[0]);
+				for (int row = 0; row < board.mHeight; row++)
+				{
+					reply.append(cells, static_cast<std::size_t>(row) * board.mWidth, board.mWidth);
+					reply += '\n';
+				}
+				reply += '\n';
+			}
+		}
+		return reply;
+	}
+
+	// Counts without enumerating, with the first count strategy that applies. The strategies count every solution,
+	// so without -T the count is only divided down to one per symmetric set where each set is known to have one
+	// solution per symmetry of the board: a rectangle without walls that no piece covers twice, where no solution
+	// can be a symmetry of itself. Returns false if the solutions have to be enumerated instead.
+	bool SolverDaemon::countCanonical(const Request& request, const PentominoBoard& canonical, int64_t& count)
+	{
+		int64_t pieces{ static_cast<int64_t>(std::count(canonical.mBoard.begin(), canonical.mBoard.end(), '0')) / 5 };
+		int orbit{ 1 };
+		if (!request.keepTrivial)
+		{
+			bool walled{ canonical.mBoard.find('1') != std::string::npos };
+			if (walled || !request.minimizeRepeats || pieces < 2 || pieces > Pentomino::cTotalBasePieces)
+				return false;
+			orbit += static_cast<int>(SolutionCanonicalizer{ canonical }.getSymmetries().size());
+		}
+
+		for (SolveStrategy strategy : { SolveStrategy::CountTransferMatrix, SolveStrategy::CountMemoized,
+			SolveStrategy::CountMeetInTheMiddle })
+		{
+			if (PentominoSolver::countSolutions(canonical, request.minimizeRepeats, strategy))
+			{
+				WideCount total{ PentominoSolver::getCountLastSolution() };
+				if (total.high != 0 || total.low > static_cast<uint64_t>(INT64_MAX))
+					return false;
+				count = static_cast<int64_t>(total.low) / orbit;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Returns nullptr if the board isn't cached, or only its count is and the solutions are needed
+	std::shared_ptr<const SolverDaemon::CacheEntry> SolverDaemon::findCached(const std::string& key, bool needSolutions)
+	{
+		std::shared_ptr<const CacheEntry> entry{};
+		{
+			std::lock_guard<std::mutex> guard{ mCacheLock };
+			auto found{ mCache.find(key) };
+			if (found != mCache.end() && (!needSolutions || found->second.first->hasSolutions))
+			{
+				mCacheOrder.splice(mCacheOrder.begin(), mCacheOrder, found->second.second);
+				entry = found->second.first;
+			}
+		}
+		std::lock_guard<std::mutex> guard{ mMetricsLock };
+		if (entry)
+			++mCacheHits;
+		else
+			++mCacheMisses;
+		return entry;
+	}
+
+	// Replaces any entry for the key, and drops the least recently used entry when full
+	void SolverDaemon::storeCached(const std::string& key, std::shared_ptr<const CacheEntry> entry)
+	{
+		std::lock_guard<std::mutex> guard{ mCacheLock };
+		auto found{ mCache.find(key) };
+		if (found != mCache.end())
+		{
+			mCacheOrder.erase(found->second.second);
+			mCache.erase(found);
+		}
+		else if (static_cast<int>(mCache.size()) >= cMaxCacheEntries)
+		{
+			mCache.erase(mCacheOrder.back());
+			mCacheOrder.pop_back();
+		}
+		mCacheOrder.push_front(key);
+		mCache.emplace(key, std::make_pair(std::move(entry), mCacheOrder.begin()));
+	}
+
+	// Written to a temporary file first and renamed over the old one, so readers never see half a file
+	void SolverDaemon::writeMetrics()
+	{
+		if (mMetricsPath.empty())
+			return;
+		int queued{};
+		int clients{};
+		{
+			std::lock_guard<std::mutex> guard{ mQueueLock };
+			queued = mQueued;
+			clients = static_cast<int>(mQueues.size());
+		}
+		int cacheEntries{};
+		{
+			std::lock_guard<std::mutex> guard{ mCacheLock };
+			cacheEntries = static_cast<int>(mCache.size());
+		}
+
+		std::lock_guard<std::mutex> guard{ mMetricsLock };
+		std::string temporary{ mMetricsPath + ".tmp" };
+		{
+			std::ofstream file{ temporary, std::ios::trunc };
+			if (!file)
+				return;
+			file << "queue_depth " << queued << "\n"
+				<< "clients_waiting " << clients << "\n"
+				<< "job_running " << (mRunning ? 1 : 0) << "\n"
+				<< "jobs_completed " << mJobsCompleted << "\n"
+				<< "total_run_seconds " << mTotalRunSeconds << "\n"
+				<< "cache_entries " << cacheEntries << "\n"
+				<< "cache_hits " << mCacheHits << "\n"
+				<< "cache_misses " << mCacheMisses << "\n";
+			for (const JobRecord& job : mRecentJobs)
+			{
+				file << "job " << job.id << " client " << job.client << " board " << job.width << "x" << job.height
+					<< " status " << job.status << " solutions " << job.solutions << " queued_seconds " << job.queuedSeconds
+					<< " run_seconds " << job.runSeconds << " cached " << (job.cached ? 1 : 0) << "\n";
+			}
+		}
+		std::error_code error{};
+		std::filesystem::rename(temporary, mMetricsPath, error);
+	}
+}
@@ -0,0 +1,62 @@
+#include "SweepLayout.h"
+
+namespace Pentominoes
+{
+	SweepLayout::SweepLayout(const PentominoBoard& board)
+	{
+		bool transposed{ board.mHeight > board.mWidth };
+		mLength = transposed ? board.mHeight : board.mWidth;
+		mSpan = transposed ? board.mWidth : board.mHeight;
+
+		// Column-major wall grid, indexed by column * mSpan + row
+		mWalls.resize(getTotalCells());
+		for (int col = 0; col < mLength; col++)
+		{
+			for (int row = 0; row < mSpan; row++)
+			{
+				int boardIndex = transposed ? col * board.mWidth + row : row * board.mWidth + col;
+				mWalls[col * mSpan + row] = board[boardIndex] != '0';
+				if (!mWalls[col * mSpan + row])
+					++mOpenCells;
+			}
+		}
+
+		buildPlacements();
+	}
+
+	void SweepLayout::buildPlacements()
+	{
+		for (int i = 0; i < Pentomino::cTotalOrientations; i++)
+		{
+			Pentomino piece{ static_cast<PieceOrientation>(i) };
+			// Anchor is the top cell of the leftmost column
+			const PieceCell* anchor{ nullptr };
+			for (const PieceCell& cell : piece.getCells())
+			{
+				if (!anchor || cell.x < anchor->x)
+					anchor = &cell;
+			}
+
+			SweepPlacement placement{};
+			placement.columns = piece.getRectangleWidth();
+			placement.base = static_cast<int>(piece.getBasePiece());
+			int nextOffset{ 0 };
+			for (const PieceCell& cell : piece.getCells())
+			{
+				int dx{ cell.x - anchor->x };
+				int dy{ cell.y - anchor->y };
+				int offset{ dx * mSpan + dy };
+				placement.offsets[nextOffset++] = offset;
+				// A cell above the anchor by more than the span makes the offset negative, but then the piece is
+				// taller than the span and never in bounds, so its mask is never read
+				if (mSpan <= cMaxSpan && offset >= 0 && offset < 64)
+					placement.mask |= uint64_t{ 1 } << offset;
+				if (dy < placement.minRow)
+					placement.minRow = dy;
+				if (dy > placement.maxRow)
+					placement.maxRow = dy;
+			}
+			mPlacements.push_back(placement);
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+namespace Pentominoes
+{
+	ThreadPool& ThreadPool::get()
+	{
+		static ThreadPool pool{ std::max(static_cast<int>(std::thread::hardware_concurrency()), 1) };
+		return pool;
+	}
+
+	ThreadPool::ThreadPool(int threads)
+	{
+		for (int i = 0; i < threads; i++)
+			mWorkers.emplace_back([this]() { work(); });
+	}
+
+	// Tasks already queued still run before the workers exit
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> guard{ mLock };
+			mShutdown = true;
+		}
+		mWake.notify_all();
+		for (std::thread& worker : mWorkers)
+			worker.join();
+	}
+
+	void ThreadPool::submit(Task task)
+	{
+		{
+			std::lock_guard<std::mutex> guard{ mLock };
+			mTasks.push_back(std::move(task));
+		}
+		mWake.notify_one();
+	}
+
+	void ThreadPool::work()
+	{
+		while (true)
+		{
+			Task task{};
+			{
+				std::unique_lock<std::mutex> guard{ mLock };
+				mWake.wait(guard, [this]() { return mShutdown || !mTasks.empty(); });
+				if (mTasks.empty())
+					return;
+				task = std::move(mTasks.front());
+				mTasks.pop_front();
+			}
+			task();
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <unordered_map>
+
+#include "TransferMatrixCounter.h"
+#include "Debug.h"
+
+namespace Pentominoes
+{
+	TransferMatrixCounter::TransferMatrixCounter(const PentominoBoard& board)
+		: mLayout{ board }
+	{
+		if (!canCount())
+			return;
+
+		// Precompute the walls visible in the profile window from each cell
+		int totalCells{ mLayout.getTotalCells() };
+		int windowSize{ 5 * mLayout.getSpan() };
+		mWallWindows.resize(totalCells);
+		for (int i = 0; i < totalCells; i++)
+		{
+			uint64_t window{ 0 };
+			for (int k = 0; k < windowSize && i + k < totalCells; k++)
+			{
+				if (mLayout.isWall(i + k))
+					window |= uint64_t{ 1 } << k;
+			}
+			mWallWindows[i] = window;
+		}
+	}
+
+	WideCount TransferMatrixCounter::count() const
+	{
+		std::unordered_map<uint64_t, WideCount> profiles{ { 0, WideCount{ 1 } } };
+		std::unordered_map<uint64_t, WideCount> nextProfiles{};
+		mLargestProfileCount = 1;
+
+		for (int cell = 0; cell < mLayout.getTotalCells(); cell++)
+		{
+			uint64_t walls{ mWallWindows[cell] };
+			nextProfiles.clear();
+
+			for (const auto& entry : profiles)
+			{
+				uint64_t profile{ entry.first };
+				if ((profile | walls) & 1)
+				{
+					// Cell already covered, nothing to place here
+					nextProfiles[profile >> 1] += entry.second;
+					continue;
+				}
+
+				// Cell is empty, so it must be the anchor of one of the pieces
+				uint64_t occupied{ profile | walls };
+				for (const SweepPlacement& placement : mLayout.getPlacements())
+				{
+					if (!mLayout.isInBounds(placement, cell) || (placement.mask & occupied))
+						continue;
+					nextProfiles[(profile | placement.mask) >> 1] += entry.second;
+				}
+			}
+
+			profiles.swap(nextProfiles);
+			if (static_cast<int>(profiles.size()) > mLargestProfileCount)
+				mLargestProfileCount = static_cast<int>(profiles.size());
+			if (profiles.empty())
+				return WideCount{};
+		}
+
+#if DEBUG_LEVEL > 0
+		std::cout << "Largest profile count: " << mLargestProfileCount << "\n";
+#endif
+		auto fullyCovered{ profiles.find(0) };
+		return fullyCovered == profiles.end() ? WideCount{} : fullyCovered->second;
+	}
+}
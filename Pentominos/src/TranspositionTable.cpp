@@ -0,0 +1,115 @@
+#include <iostream>
+
+#include "TranspositionTable.h"
+
+namespace Pentominoes
+{
+	void TranspositionStats::print() const
+	{
+		std::cout << "Transposition table: " << lookups << " lookups, " << hits << " hits ("
+			<< getHitRate() * 100.0 << "%), " << stores << " stores, " << evictions << " evictions\n";
+	}
+
+	template <int Words>
+	TranspositionTable<Words>::TranspositionTable(std::size_t bytes)
+		: mStripes{ new Stripe[cStripes] }
+	{
+		// Largest power of 2 number of buckets that fits
+		std::size_t buckets{ 1 };
+		while (buckets * 2 * cWays * sizeof(Entry) <= bytes)
+			buckets *= 2;
+		mEntries.resize(buckets * cWays);
+		mBucketMask = buckets - 1;
+	}
+
+	template <int Words>
+	std::size_t TranspositionTable<Words>::getBucket(const Board& open, uint32_t usedPieces) const
+	{
+		// Mix each word in with the splitmix64 finalizer, so every bit of the state reaches the bucket index
+		uint64_t hash{ usedPieces };
+		for (int w = 0; w < Words; w++)
+		{
+			hash = (hash ^ open.words[w]) + 0x9E3779B97F4A7C15ull;
+			hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+			hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+			hash ^= hash >> 31;
+		}
+		return static_cast<std::size_t>(hash) & mBucketMask;
+	}
+
+	template <int Words>
+	bool TranspositionTable<Words>::find(const Board& open, uint32_t usedPieces, WideCount& count)
+	{
+		std::size_t bucket{ getBucket(open, usedPieces) };
+		Stripe& stripe{ mStripes[bucket % cStripes] };
+		std::lock_guard<std::mutex> guard{ stripe.lock };
+		++stripe.stats.lookups;
+		const Entry* entries{ mEntries.data() + bucket * cWays };
+		for (int i = 0; i < cWays; i++)
+		{
+			if (entries[i].openCells > 0 && entries[i].usedPieces == usedPieces && entries[i].open == open)
+			{
+				++stripe.stats.hits;
+				count = entries[i].count;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template <int Words>
+	void TranspositionTable<Words>::store(const Board& open, uint32_t usedPieces, int openCells, const WideCount& count)
+	{
+		std::size_t bucket{ getBucket(open, usedPieces) };
+		Stripe& stripe{ mStripes[bucket % cStripes] };
+		std::lock_guard<std::mutex> guard{ stripe.lock };
+		++stripe.stats.stores;
+
+		// Take the first empty slot or a slot with the same state (another thread may have counted it too),
+		// otherwise the slot with the smallest subtree
+		Entry* entries{ mEntries.data() + bucket * cWays };
+		Entry* target{ &entries[0] };
+		for (int i = 0; i < cWays; i++)
+		{
+			Entry& entry{ entries[i] };
+			if (entry.openCells == 0 || (entry.usedPieces == usedPieces && entry.open == open))
+			{
+				target = &entry;
+				break;
+			}
+			if (entry.openCells < target->openCells)
+				target = &entry;
+		}
+		if (target->openCells > 0 && !(target->usedPieces == usedPieces && target->open == open))
+		{
+			// Keep the larger subtree if the new state is smaller than everything in the bucket
+			if (target->openCells > openCells)
+				return;
+			++stripe.stats.evictions;
+		}
+		target->open = open;
+		target->usedPieces = usedPieces;
+		target->openCells = openCells;
+		target->count = count;
+	}
+
+	template <int Words>
+	TranspositionStats TranspositionTable<Words>::getStats() const
+	{
+		TranspositionStats total{};
+		for (int i = 0; i < cStripes; i++)
+		{
+			std::lock_guard<std::mutex> guard{ mStripes[i].lock };
+			total.lookups += mStripes[i].stats.lookups;
+			total.hits += mStripes[i].stats.hits;
+			total.stores += mStripes[i].stats.stores;
+			total.evictions += mStripes[i].stats.evictions;
+		}
+		return total;
+	}
+
+	template class TranspositionTable<1>;
+	template class TranspositionTable<2>;
+	template class TranspositionTable<4>;
+	template class TranspositionTable<8>;
+}
@@ -1,14 +1,27 @@
 #include <iostream>
 #include <string>
 
+#include "AllocationTracker.h"
 #include "Pentomino.h"
 #include "PentominoBoard.h"
 #include "PentominoSolver.h"
+#include "SelfCheck.h"
+#include "SolverDaemon.h"
 
 
 
-int main()
+int main(int argc, char* argv[])
 {
+	// Serve requests from other processes instead of prompting: Pentominos --daemon [endpoint] [metrics file]
+	if (argc > 1 && std::string{ argv[1] } == "--daemon")
+	{
+		Pentominoes::SolverDaemon daemon{ argc > 2 ? argv[2] : Pentominoes::SolverDaemon::getDefaultEndpoint(),
+			argc > 3 ? argv[3] : "pentominos-metrics.txt" };
+		return daemon.run() ? 0 : 1;
+	}
+	// Check the solver's strategies against each other: Pentominos --check
+	if (argc > 1 && std::string{ argv[1] } == "--check")
+		return Pentominoes::SelfCheck::runAll() ? 0 : 1;
 
 	Pentominoes::Pentomino::printAll();
 	std::vector<Pentominoes::Pentomino> vec;
@@ -19,9 +32,18 @@ int main()
 	
 
 
-	Pentominoes::PentominoSolver::findAllSolutions(board, true, true);
-
-	Pentominoes::PentominoSolver::removeTrivialSolutions();
+	// Trivial solutions are removed and the rest printed while the search runs
+	Pentominoes::AllocationTracker::reset();
+	Pentominoes::PentominoSolver::findUniqueSolutions(board, true, true, true);
+#if TRACK_ALLOCATIONS
+	// Fail the run if the search itself touched the heap
+	Pentominoes::AllocationTracker::print();
+	if (Pentominoes::AllocationTracker::getCount(Pentominoes::AllocationPhase::Search) > 0)
+	{
+		std::cout << "The search loop allocated\n";
+		return 1;
+	}
+#endif
 	
 
 	/*
@@ -31,7 +53,6 @@ int main()
 	*/
 	//Pentominoes::PentominoSolver::findAllSolutions(board);
 	//Pentominoes::PentominoSolver solver(board);
-	Pentominoes::PentominoSolver::printSolutions();
 	
 }
 